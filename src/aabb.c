@@ -0,0 +1,75 @@
+/**
+ * aabb.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <math.h>
+#include <stddef.h>
+
+#include "vector/vec3.h"
+#include "matrix/mat4.h"
+#include "aabb.h"
+
+/**
+ * Transforms a center/extent pair in place.
+ * Shared by the single and batch versions so that the batch loops can
+ * inline it.
+ */
+static inline void transform_ce(cgm_vec3* c, cgm_vec3* e,
+        const cgm_mat4* m) {
+    float cx = c->x, cy = c->y, cz = c->z;
+    float ex = e->x, ey = e->y, ez = e->z;
+
+    for (int j = 0; j < 3; j++) {
+        c->v[j] = m->m[0][j] * cx + m->m[1][j] * cy + m->m[2][j] * cz
+            + m->m[3][j];
+        e->v[j] = fabsf(m->m[0][j]) * ex + fabsf(m->m[1][j]) * ey
+            + fabsf(m->m[2][j]) * ez;
+    }
+}
+
+static inline void transform_min_max(cgm_aabb* box, const cgm_mat4* m) {
+    cgm_vec3 c, e;
+    for (int j = 0; j < 3; j++) {
+        c.v[j] = (box->max.v[j] + box->min.v[j]) * 0.5F;
+        e.v[j] = (box->max.v[j] - box->min.v[j]) * 0.5F;
+    }
+
+    transform_ce(&c, &e, m);
+
+    for (int j = 0; j < 3; j++) {
+        box->min.v[j] = c.v[j] - e.v[j];
+        box->max.v[j] = c.v[j] + e.v[j];
+    }
+}
+
+void cgm_aabb_set(cgm_aabb* box, const cgm_vec3* min, const cgm_vec3* max) {
+    cgm_vec3_cpy(&box->min, min);
+    cgm_vec3_cpy(&box->max, max);
+}
+
+void cgm_aabb_transform(cgm_aabb* box, const cgm_mat4* m) {
+    transform_min_max(box, m);
+}
+
+void cgm_aabb_transform_n(cgm_aabb* boxes, const cgm_mat4* m, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        transform_min_max(&boxes[i], &m[i]);
+    }
+}
+
+void cgm_aabb_transform_ce(cgm_vec3* center, cgm_vec3* extent,
+        const cgm_mat4* m) {
+    transform_ce(center, extent, m);
+}
+
+void cgm_aabb_transform_ce_n(cgm_vec3* centers, cgm_vec3* extents,
+        const cgm_mat4* m, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        transform_ce(&centers[i], &extents[i], &m[i]);
+    }
+}
+
+/* vim: set ft=c: */
@@ -0,0 +1,89 @@
+/**
+ * aabb.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Axis-aligned bounding boxes and their transformation by affine
+ * matrices.
+ */
+
+#ifndef AABB_H_
+#define AABB_H_
+
+#include <stddef.h>
+
+#include "vector/vec3.h"
+#include "matrix/mat4.h"
+
+/**
+ * An axis-aligned bounding box stored as its minimum and maximum
+ * corners.
+ */
+typedef struct cgm_aabb {
+    /**
+     * Corner with the smallest coordinates.
+     */
+    cgm_vec3 min;
+
+    /**
+     * Corner with the largest coordinates.
+     */
+    cgm_vec3 max;
+} cgm_aabb;
+
+/**
+ * Sets the corners of a cgm_aabb.
+ * @param box - Box to set.
+ * @param min - Corner with the smallest coordinates.
+ * @param max - Corner with the largest coordinates.
+ */
+void cgm_aabb_set(cgm_aabb* box, const cgm_vec3* min, const cgm_vec3* max);
+
+/**
+ * Transforms a cgm_aabb by an affine cgm_mat4.
+ * The result is the smallest axis-aligned box containing the transformed
+ * box. Rather than transforming all 8 corners, the extent of the box is
+ * multiplied by the element-wise absolute value of the upper-left 3x3
+ * block of the matrix (Arvo's method).
+ * The last row of m is assumed to be (0, 0, 0, 1).
+ * @param box - Box to transform.
+ * @param m - Affine matrix to transform by.
+ */
+void cgm_aabb_transform(cgm_aabb* box, const cgm_mat4* m);
+
+/**
+ * Transforms an array of cgm_aabb's, each by its own affine cgm_mat4.
+ * This is equivalent to calling cgm_aabb_transform() on each pair.
+ * @param boxes - Array of n boxes to transform.
+ * @param m - Array of n affine matrices; boxes[i] is transformed by m[i].
+ * @param n - Number of boxes.
+ */
+void cgm_aabb_transform_n(cgm_aabb* boxes, const cgm_mat4* m, size_t n);
+
+/**
+ * Transforms a box in center/extent form by an affine cgm_mat4.
+ * The extent is the half-size of the box along each axis.
+ * The last row of m is assumed to be (0, 0, 0, 1).
+ * @param center - Center of the box to transform.
+ * @param extent - Half-size of the box to transform.
+ * @param m - Affine matrix to transform by.
+ */
+void cgm_aabb_transform_ce(cgm_vec3* center, cgm_vec3* extent,
+        const cgm_mat4* m);
+
+/**
+ * Transforms arrays of boxes in center/extent form, each by its own
+ * affine cgm_mat4.
+ * This is equivalent to calling cgm_aabb_transform_ce() on each triple.
+ * @param centers - Array of n box centers.
+ * @param extents - Array of n box half-sizes.
+ * @param m - Array of n affine matrices.
+ * @param n - Number of boxes.
+ */
+void cgm_aabb_transform_ce_n(cgm_vec3* centers, cgm_vec3* extents,
+        const cgm_mat4* m, size_t n);
+
+#endif /* AABB_H_ */
+
+/* vim: set ft=c: */
@@ -0,0 +1,329 @@
+/**
+ * camera.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "vector/vec3.h"
+#include "vector/vec4.h"
+#include "matrix/mat4.h"
+#include "transform.h"
+#include "camera.h"
+
+#define VIEW_VALID 1U
+#define PROJECTION_VALID 2U
+#define VIEW_PROJECTION_VALID 4U
+#define INVERSE_VIEW_PROJECTION_VALID 8U
+#define PLANES_VALID 16U
+
+/**
+ * Caches which depend on the view and on the projection.
+ */
+#define VIEW_DEPENDENT (VIEW_VALID | VIEW_PROJECTION_VALID \
+        | INVERSE_VIEW_PROJECTION_VALID | PLANES_VALID)
+#define PROJECTION_DEPENDENT (PROJECTION_VALID | VIEW_PROJECTION_VALID \
+        | INVERSE_VIEW_PROJECTION_VALID | PLANES_VALID)
+
+/**
+ * Sets a plane to a + sign b, scaled to a unit normal.
+ */
+static inline void plane(cgm_vec4* p, const cgm_vec4* a, const cgm_vec4* b,
+        float sign) {
+    cgm_vec4_set(p, a->x + sign * b->x, a->y + sign * b->y,
+            a->z + sign * b->z, a->w + sign * b->w);
+
+    float mag = sqrtf(p->x * p->x + p->y * p->y + p->z * p->z);
+    if (mag == 0) {
+        cgm_vec4_set(p, 0, 0, 0, 1);
+    } else {
+        cgm_vec4_scal(p, 1 / mag);
+    }
+}
+
+void cgm_frustum_planes(cgm_vec4* planes, const cgm_mat4* vp,
+        cgm_depth_range depth) {
+    /* Rows of vp; the clip coordinates of p are (r[i] . (p, 1)) */
+    cgm_vec4 r[4];
+    for (int i = 0; i < 4; i++) {
+        cgm_vec4_set(&r[i], vp->m[0][i], vp->m[1][i], vp->m[2][i],
+                vp->m[3][i]);
+    }
+
+    cgm_vec4 zero;
+    cgm_vec4_fill(&zero, 0);
+
+    plane(&planes[0], &r[3], &r[0], 1);
+    plane(&planes[1], &r[3], &r[0], -1);
+    plane(&planes[2], &r[3], &r[1], 1);
+    plane(&planes[3], &r[3], &r[1], -1);
+
+    switch (depth) {
+    case CGM_DEPTH_ZERO_TO_ONE:
+        /* 0 <= z' <= w' */
+        plane(&planes[4], &r[2], &zero, 0);
+        plane(&planes[5], &r[3], &r[2], -1);
+        break;
+    case CGM_DEPTH_ONE_TO_ZERO:
+        /* w' >= z' >= 0 */
+        plane(&planes[4], &r[3], &r[2], -1);
+        plane(&planes[5], &r[2], &zero, 0);
+        break;
+    default:
+        /* -w' <= z' <= w' */
+        plane(&planes[4], &r[3], &r[2], 1);
+        plane(&planes[5], &r[3], &r[2], -1);
+        break;
+    }
+}
+
+static inline bool perspective_valid(float fov_y, float aspect,
+        float near, float far) {
+    /* Written so that NaN fails every comparison. A fov_y of pi (even
+     * rounded to float) would give a negative cotangent, so it is
+     * excluded along with zero.
+     */
+    return fov_y > 0 && fov_y < M_PI &&
+            aspect > 0 &&
+            near > 0 &&
+            far > near;
+}
+
+/**
+ * Sets vp to p * v for a view v and a perspective projection p.
+ * The only non-zero terms of p are x' = sx x, y' = sy y, z' = a z + b w,
+ * and w' = -z, so the rows of vp are sx v0, sy v1, a v2 + b (0, 0, 0, 1),
+ * and -v2.
+ */
+static inline void mul_view_projection(cgm_mat4* vp, const cgm_mat4* v,
+        const cgm_mat4* p) {
+    float sx = p->m[0][0];
+    float sy = p->m[1][1];
+    float a = p->m[2][2];
+    float b = p->m[3][2];
+
+    for (int j = 0; j < 4; j++) {
+        vp->m[j][0] = sx * v->m[j][0];
+        vp->m[j][1] = sy * v->m[j][1];
+        vp->m[j][2] = a * v->m[j][2];
+        vp->m[j][3] = -v->m[j][2];
+    }
+    vp->m[3][2] += b;
+}
+
+/**
+ * Sets inv to the inverse of p * v from the inverse view iv.
+ * The inverse of p takes (x', y', z', w') to (x' / sx, y' / sy, -w',
+ * (z' + a w') / b), and iv has columns s, u, -f, and (eye, 1), so their
+ * product has columns s / sx, u / sy, (eye, 1) / b, and
+ * f + (eye, 1) a / b. inv may be the same as iv.
+ */
+static inline void invert_view_projection(cgm_mat4* inv,
+        const cgm_mat4* iv, const cgm_mat4* p) {
+    float sx = p->m[0][0];
+    float sy = p->m[1][1];
+    float a = p->m[2][2];
+    float b = p->m[3][2];
+    float c = a / b;
+
+    for (int i = 0; i < 4; i++) {
+        float e = iv->m[3][i];
+        float f = -iv->m[2][i];
+        inv->m[0][i] = iv->m[0][i] / sx;
+        inv->m[1][i] = iv->m[1][i] / sy;
+        inv->m[2][i] = e / b;
+        inv->m[3][i] = f + e * c;
+    }
+}
+
+bool cgm_camera_matrices(
+        cgm_mat4* view,
+        cgm_mat4* projection,
+        cgm_mat4* view_projection,
+        cgm_mat4* inverse_view_projection,
+        cgm_vec4* planes,
+        const cgm_vec3* eye,
+        const cgm_vec3* center,
+        const cgm_vec3* up,
+        float fov_y, float aspect,
+        float near, float far,
+        cgm_depth_range depth) {
+    if (!perspective_valid(fov_y, aspect, near, far)) {
+        return false;
+    }
+
+    cgm_mat4 v, iv, p, vp;
+    cgm_set_lookat_inverse(&v, &iv, eye, center, up);
+    cgm_set_perspective_depth(&p, fov_y, aspect, near, far, depth);
+    mul_view_projection(&vp, &v, &p);
+
+    if (view != NULL) {
+        *view = v;
+    }
+    if (projection != NULL) {
+        *projection = p;
+    }
+    if (view_projection != NULL) {
+        *view_projection = vp;
+    }
+    if (inverse_view_projection != NULL) {
+        invert_view_projection(inverse_view_projection, &iv, &p);
+    }
+    if (planes != NULL) {
+        cgm_frustum_planes(planes, &vp, depth);
+    }
+
+    return true;
+}
+
+bool cgm_camera_init(
+        cgm_camera* c,
+        const cgm_vec3* eye,
+        const cgm_vec3* target,
+        const cgm_vec3* up,
+        float fov_y, float aspect,
+        float near, float far,
+        cgm_depth_range depth) {
+    if (!perspective_valid(fov_y, aspect, near, far)) {
+        return false;
+    }
+
+    c->eye = *eye;
+    c->target = *target;
+    c->up = *up;
+    c->fov_y = fov_y;
+    c->aspect = aspect;
+    c->near = near;
+    c->far = far;
+    c->depth = depth;
+    c->valid = 0;
+    return true;
+}
+
+void cgm_camera_set_lookat(
+        cgm_camera* c,
+        const cgm_vec3* eye,
+        const cgm_vec3* target,
+        const cgm_vec3* up) {
+    c->eye = *eye;
+    c->target = *target;
+    c->up = *up;
+    c->valid &= ~VIEW_DEPENDENT;
+}
+
+void cgm_camera_set_eye(cgm_camera* c, const cgm_vec3* eye) {
+    c->eye = *eye;
+    c->valid &= ~VIEW_DEPENDENT;
+}
+
+void cgm_camera_set_target(cgm_camera* c, const cgm_vec3* target) {
+    c->target = *target;
+    c->valid &= ~VIEW_DEPENDENT;
+}
+
+void cgm_camera_set_up(cgm_camera* c, const cgm_vec3* up) {
+    c->up = *up;
+    c->valid &= ~VIEW_DEPENDENT;
+}
+
+bool cgm_camera_set_fov_y(cgm_camera* c, float fov_y) {
+    if (!perspective_valid(fov_y, c->aspect, c->near, c->far)) {
+        return false;
+    }
+
+    c->fov_y = fov_y;
+    c->valid &= ~PROJECTION_DEPENDENT;
+    return true;
+}
+
+bool cgm_camera_set_aspect(cgm_camera* c, float aspect) {
+    if (!perspective_valid(c->fov_y, aspect, c->near, c->far)) {
+        return false;
+    }
+
+    c->aspect = aspect;
+    c->valid &= ~PROJECTION_DEPENDENT;
+    return true;
+}
+
+bool cgm_camera_set_clip(cgm_camera* c, float near, float far) {
+    if (!perspective_valid(c->fov_y, c->aspect, near, far)) {
+        return false;
+    }
+
+    c->near = near;
+    c->far = far;
+    c->valid &= ~PROJECTION_DEPENDENT;
+    return true;
+}
+
+void cgm_camera_set_depth_range(cgm_camera* c, cgm_depth_range depth) {
+    c->depth = depth;
+    c->valid &= ~PROJECTION_DEPENDENT;
+}
+
+void cgm_camera_update(cgm_camera* c) {
+    cgm_camera_inverse_view_projection(c);
+    cgm_camera_planes(c);
+}
+
+const cgm_mat4* cgm_camera_view(cgm_camera* c) {
+    if (!(c->valid & VIEW_VALID)) {
+        cgm_set_lookat_inverse(&c->view, &c->inverse_view,
+                &c->eye, &c->target, &c->up);
+        c->valid |= VIEW_VALID;
+    }
+
+    return &c->view;
+}
+
+const cgm_mat4* cgm_camera_inverse_view(cgm_camera* c) {
+    cgm_camera_view(c);
+    return &c->inverse_view;
+}
+
+const cgm_mat4* cgm_camera_projection(cgm_camera* c) {
+    if (!(c->valid & PROJECTION_VALID)) {
+        cgm_set_perspective_depth(&c->projection, c->fov_y, c->aspect,
+                c->near, c->far, c->depth);
+        c->valid |= PROJECTION_VALID;
+    }
+
+    return &c->projection;
+}
+
+const cgm_mat4* cgm_camera_view_projection(cgm_camera* c) {
+    if (!(c->valid & VIEW_PROJECTION_VALID)) {
+        mul_view_projection(&c->view_projection, cgm_camera_view(c),
+                cgm_camera_projection(c));
+        c->valid |= VIEW_PROJECTION_VALID;
+    }
+
+    return &c->view_projection;
+}
+
+const cgm_mat4* cgm_camera_inverse_view_projection(cgm_camera* c) {
+    if (!(c->valid & INVERSE_VIEW_PROJECTION_VALID)) {
+        invert_view_projection(&c->inverse_view_projection,
+                cgm_camera_inverse_view(c), cgm_camera_projection(c));
+        c->valid |= INVERSE_VIEW_PROJECTION_VALID;
+    }
+
+    return &c->inverse_view_projection;
+}
+
+const cgm_vec4* cgm_camera_planes(cgm_camera* c) {
+    if (!(c->valid & PLANES_VALID)) {
+        cgm_frustum_planes(c->planes, cgm_camera_view_projection(c),
+                c->depth);
+        c->valid |= PLANES_VALID;
+    }
+
+    return c->planes;
+}
+
+/* vim: set ft=c: */
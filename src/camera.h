@@ -0,0 +1,257 @@
+/**
+ * camera.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Function prototypes for building all of the matrices of a perspective
+ * camera at once, and a camera which caches them.
+ */
+
+#ifndef CAMERA_H_
+#define CAMERA_H_
+
+#include <stdbool.h>
+
+#include "vector/vec3.h"
+#include "vector/vec4.h"
+#include "matrix/mat4.h"
+#include "transform.h"
+
+/**
+ * Extracts the 6 clipping planes of a view-projection matrix.
+ * The planes are stored as left, right, bottom, top, near, and far, each
+ * as (a, b, c, d) with (a, b, c) a unit normal pointing into the frustum,
+ * so that a point p is inside when a p.x + b p.y + c p.z + d >= 0 for
+ * every plane. A plane at infinity is stored as (0, 0, 0, 1).
+ * @param planes - Array of 6 planes to set.
+ * @param vp - View-projection matrix.
+ * @param depth - Depth range of the projection.
+ */
+void cgm_frustum_planes(cgm_vec4* planes, const cgm_mat4* vp,
+        cgm_depth_range depth);
+
+/**
+ * Sets the view, projection, view-projection, and inverse view-projection
+ * matrices and the frustum planes of a perspective camera.
+ * The results are the same as from cgm_set_lookat(),
+ * cgm_set_perspective_depth(), cgm_mat4_mul(), cgm_mat4_invert(), and
+ * cgm_frustum_planes() in turn, but the products and the inverse are
+ * written out directly from the few non-zero terms of the two matrices.
+ * Any of the outputs may be NULL to skip it.
+ * @param view - Matrix to set to the view matrix.
+ * @param projection - Matrix to set to the projection matrix.
+ * @param view_projection - Matrix to set to projection * view.
+ * @param inverse_view_projection - Matrix to set to the inverse of
+ *                                  projection * view.
+ * @param planes - Array of 6 planes to set, as by cgm_frustum_planes().
+ * @param eye - Position of the eye.
+ * @param center - Position of the reference point.
+ * @param up - Upward direction.
+ * @param fov_y - The Field of View in the y (vertical) direction.
+ *                Measured in radians
+ * @param aspect_ratio - The aspect ratio of the clipping pane.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane, or INFINITY.
+ * @param depth - Depths to map near and far to.
+ * @return true (1) if the projection is valid (0 < fov_y < pi,
+ *         aspect_ratio > 0, and 0 < near < far, none NaN); false (0)
+ *         otherwise, in which case nothing is set.
+ */
+bool cgm_camera_matrices(
+        cgm_mat4* view,
+        cgm_mat4* projection,
+        cgm_mat4* view_projection,
+        cgm_mat4* inverse_view_projection,
+        cgm_vec4* planes,
+        const cgm_vec3* eye,
+        const cgm_vec3* center,
+        const cgm_vec3* up,
+        float fov_y, float aspect_ratio,
+        float near, float far,
+        cgm_depth_range depth);
+
+/**
+ * A perspective camera with its derived matrices cached.
+ * Setters only store their values and mark what depends on them as out
+ * of date; the getters recompute just that on the next call. Since the
+ * getters write the caches, a camera shared between threads should be
+ * brought up to date with cgm_camera_update() after it is changed, after
+ * which the getters only read it.
+ */
+typedef struct cgm_camera {
+    /**
+     * View parameters, as for cgm_set_lookat().
+     */
+    cgm_vec3 eye, target, up;
+
+    /**
+     * Projection parameters, as for cgm_set_perspective_depth().
+     */
+    float fov_y, aspect, near, far;
+    cgm_depth_range depth;
+
+    /**
+     * Cached matrices and planes, valid where set in valid.
+     */
+    cgm_mat4 view;
+    cgm_mat4 inverse_view;
+    cgm_mat4 projection;
+    cgm_mat4 view_projection;
+    cgm_mat4 inverse_view_projection;
+    cgm_vec4 planes[6];
+    unsigned valid;
+} cgm_camera;
+
+/**
+ * Initializes a cgm_camera.
+ * @param c - Camera to initialize.
+ * @param eye - Position of the eye.
+ * @param target - Position of the reference point.
+ * @param up - Upward direction.
+ * @param fov_y - The Field of View in the y (vertical) direction.
+ *                Measured in radians
+ * @param aspect_ratio - The aspect ratio of the clipping pane.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane, or INFINITY.
+ * @param depth - Depths to map near and far to.
+ * @return true (1) if the projection is valid, as for
+ *         cgm_camera_matrices(); false (0) otherwise, in which case the
+ *         camera is not initialized.
+ */
+bool cgm_camera_init(
+        cgm_camera* c,
+        const cgm_vec3* eye,
+        const cgm_vec3* target,
+        const cgm_vec3* up,
+        float fov_y, float aspect_ratio,
+        float near, float far,
+        cgm_depth_range depth);
+
+/**
+ * Sets the eye, target, and up direction of a camera.
+ * @param c - Camera to change.
+ * @param eye - Position of the eye.
+ * @param target - Position of the reference point.
+ * @param up - Upward direction.
+ */
+void cgm_camera_set_lookat(
+        cgm_camera* c,
+        const cgm_vec3* eye,
+        const cgm_vec3* target,
+        const cgm_vec3* up);
+
+/**
+ * Sets the eye position of a camera.
+ * @param c - Camera to change.
+ * @param eye - Position of the eye.
+ */
+void cgm_camera_set_eye(cgm_camera* c, const cgm_vec3* eye);
+
+/**
+ * Sets the target position of a camera.
+ * @param c - Camera to change.
+ * @param target - Position of the reference point.
+ */
+void cgm_camera_set_target(cgm_camera* c, const cgm_vec3* target);
+
+/**
+ * Sets the up direction of a camera.
+ * @param c - Camera to change.
+ * @param up - Upward direction.
+ */
+void cgm_camera_set_up(cgm_camera* c, const cgm_vec3* up);
+
+/**
+ * Sets the vertical field of view of a camera.
+ * @param c - Camera to change.
+ * @param fov_y - The Field of View in the y (vertical) direction.
+ *                Measured in radians
+ * @return true (1) if the projection is valid, as for
+ *         cgm_camera_matrices(); false (0) otherwise, in which case the
+ *         camera is unchanged.
+ */
+bool cgm_camera_set_fov_y(cgm_camera* c, float fov_y);
+
+/**
+ * Sets the aspect ratio of a camera.
+ * @param c - Camera to change.
+ * @param aspect_ratio - The aspect ratio of the clipping pane.
+ * @return true (1) if the projection is valid, as for
+ *         cgm_camera_matrices(); false (0) otherwise, in which case the
+ *         camera is unchanged.
+ */
+bool cgm_camera_set_aspect(cgm_camera* c, float aspect_ratio);
+
+/**
+ * Sets the near and far planes of a camera.
+ * @param c - Camera to change.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane, or INFINITY.
+ * @return true (1) if the projection is valid, as for
+ *         cgm_camera_matrices(); false (0) otherwise, in which case the
+ *         camera is unchanged.
+ */
+bool cgm_camera_set_clip(cgm_camera* c, float near, float far);
+
+/**
+ * Sets the depth range of a camera.
+ * @param c - Camera to change.
+ * @param depth - Depths to map near and far to.
+ */
+void cgm_camera_set_depth_range(cgm_camera* c, cgm_depth_range depth);
+
+/**
+ * Brings all of the cached matrices and planes of a camera up to date.
+ * @param c - Camera to update.
+ */
+void cgm_camera_update(cgm_camera* c);
+
+/**
+ * Gets the view matrix of a camera.
+ * @param c - The camera.
+ * @return The view matrix, valid until the camera is next changed.
+ */
+const cgm_mat4* cgm_camera_view(cgm_camera* c);
+
+/**
+ * Gets the inverse of the view matrix of a camera (its world matrix).
+ * @param c - The camera.
+ * @return The inverse view matrix, valid until the camera is next
+ *         changed.
+ */
+const cgm_mat4* cgm_camera_inverse_view(cgm_camera* c);
+
+/**
+ * Gets the projection matrix of a camera.
+ * @param c - The camera.
+ * @return The projection matrix, valid until the camera is next changed.
+ */
+const cgm_mat4* cgm_camera_projection(cgm_camera* c);
+
+/**
+ * Gets the view-projection matrix (projection * view) of a camera.
+ * @param c - The camera.
+ * @return The view-projection matrix, valid until the camera is next
+ *         changed.
+ */
+const cgm_mat4* cgm_camera_view_projection(cgm_camera* c);
+
+/**
+ * Gets the inverse of the view-projection matrix of a camera.
+ * @param c - The camera.
+ * @return The inverse view-projection matrix, valid until the camera is
+ *         next changed.
+ */
+const cgm_mat4* cgm_camera_inverse_view_projection(cgm_camera* c);
+
+/**
+ * Gets the frustum planes of a camera, as by cgm_frustum_planes().
+ * @param c - The camera.
+ * @return Array of 6 planes, valid until the camera is next changed.
+ */
+const cgm_vec4* cgm_camera_planes(cgm_camera* c);
+
+#endif /* CAMERA_H_ */
+
+/* vim: set ft=c: */
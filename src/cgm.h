@@ -17,6 +17,9 @@
 #include "matrix/mat2.h"
 #include "matrix/mat3.h"
 #include "matrix/mat4.h"
+#include "quaternion/dualquat.h"
+#include "matrix/mat4stack.h"
+#include "matrix/affine.h"
 
 #include "vector/dvec2.h"
 #include "vector/dvec3.h"
@@ -38,8 +41,20 @@
 #include "vector/bvec3.h"
 #include "vector/bvec4.h"
 
+#include "vector/half.h"
+#include "vector/hvec2.h"
+#include "vector/hvec3.h"
+#include "vector/hvec4.h"
+
 #include "transform.h"
 #include "project.h"
+#include "camera.h"
+#include "pack.h"
+#include "aabb.h"
+#include "pool.h"
+#include "reduce.h"
+#include "skin.h"
+#include "hierarchy.h"
 
 #endif /* CGM_H_ */
 
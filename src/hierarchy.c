@@ -0,0 +1,295 @@
+/**
+ * hierarchy.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vector/vec3.h"
+#include "quaternion/quaternion.h"
+#include "matrix/mat4.h"
+#include "pool.h"
+#include "hierarchy.h"
+
+/**
+ * Sets m to the local matrix T * R * S of node i.
+ */
+static inline void local_matrix(cgm_mat4* m, const cgm_hierarchy* h,
+        size_t i) {
+    cgm_vec3 t, s;
+    cgm_quat r;
+    cgm_vec3_set(&t, h->translation.x[i], h->translation.y[i],
+            h->translation.z[i]);
+    cgm_quat_set(&r, h->rotation.w[i], h->rotation.x[i],
+            h->rotation.y[i], h->rotation.z[i]);
+    cgm_vec3_set(&s, h->scale.x[i], h->scale.y[i], h->scale.z[i]);
+    cgm_mat4_from_trs(m, &t, &r, &s);
+}
+
+/**
+ * Grows one array of a hierarchy to COUNT elements, returning false from
+ * the enclosing function (and leaving the array unchanged) on failure.
+ */
+#define GROW(ARR, COUNT) \
+    do { \
+        void* tmp = realloc((ARR), (COUNT) * sizeof(*(ARR))); \
+        if (tmp == NULL) { \
+            return false; \
+        } \
+        (ARR) = tmp; \
+    } while (0)
+
+/**
+ * Makes space for at least capacity nodes.
+ * The capacity is only raised once every array has grown, so a failure
+ * part way through leaves a usable (if partly oversized) hierarchy.
+ */
+static bool reserve(cgm_hierarchy* h, size_t capacity) {
+    if (capacity <= h->capacity) {
+        return true;
+    }
+
+    GROW(h->parent, capacity);
+    GROW(h->translation.x, capacity);
+    GROW(h->translation.y, capacity);
+    GROW(h->translation.z, capacity);
+    GROW(h->rotation.w, capacity);
+    GROW(h->rotation.x, capacity);
+    GROW(h->rotation.y, capacity);
+    GROW(h->rotation.z, capacity);
+    GROW(h->scale.x, capacity);
+    GROW(h->scale.y, capacity);
+    GROW(h->scale.z, capacity);
+    GROW(h->world, capacity);
+    GROW(h->dirty, capacity);
+
+    h->capacity = capacity;
+    return true;
+}
+
+bool cgm_hierarchy_init(cgm_hierarchy* h, size_t capacity) {
+    memset(h, 0, sizeof(cgm_hierarchy));
+    return reserve(h, capacity);
+}
+
+void cgm_hierarchy_free(cgm_hierarchy* h) {
+    free(h->parent);
+    free(h->translation.x);
+    free(h->translation.y);
+    free(h->translation.z);
+    free(h->rotation.w);
+    free(h->rotation.x);
+    free(h->rotation.y);
+    free(h->rotation.z);
+    free(h->scale.x);
+    free(h->scale.y);
+    free(h->scale.z);
+    free(h->world);
+    free(h->dirty);
+    memset(h, 0, sizeof(cgm_hierarchy));
+}
+
+size_t cgm_hierarchy_add(cgm_hierarchy* h, size_t parent,
+        const cgm_vec3* translation,
+        const cgm_quat* rotation,
+        const cgm_vec3* scale) {
+    if (parent != CGM_HIERARCHY_ROOT && parent >= h->count) {
+        return CGM_HIERARCHY_ROOT;
+    }
+
+    if (h->count == h->capacity
+            && !reserve(h, h->capacity < 16 ? 16 : h->capacity * 2)) {
+        return CGM_HIERARCHY_ROOT;
+    }
+
+    size_t i = h->count++;
+    h->parent[i] = parent;
+    cgm_hierarchy_set_translation(h, i, translation);
+    cgm_hierarchy_set_rotation(h, i, rotation);
+    cgm_hierarchy_set_scale(h, i, scale);
+    return i;
+}
+
+void cgm_hierarchy_set_translation(cgm_hierarchy* h, size_t i,
+        const cgm_vec3* translation) {
+    h->translation.x[i] = translation->x;
+    h->translation.y[i] = translation->y;
+    h->translation.z[i] = translation->z;
+    h->dirty[i] = true;
+}
+
+void cgm_hierarchy_set_rotation(cgm_hierarchy* h, size_t i,
+        const cgm_quat* rotation) {
+    h->rotation.w[i] = rotation->w;
+    h->rotation.x[i] = rotation->x;
+    h->rotation.y[i] = rotation->y;
+    h->rotation.z[i] = rotation->z;
+    h->dirty[i] = true;
+}
+
+void cgm_hierarchy_set_scale(cgm_hierarchy* h, size_t i,
+        const cgm_vec3* scale) {
+    h->scale.x[i] = scale->x;
+    h->scale.y[i] = scale->y;
+    h->scale.z[i] = scale->z;
+    h->dirty[i] = true;
+}
+
+void cgm_hierarchy_mark_dirty(cgm_hierarchy* h, size_t i) {
+    h->dirty[i] = true;
+}
+
+/**
+ * Number of matrices gathered for each cgm_mat4_mul_n() call of a level
+ * chunk.
+ */
+#define BATCH 32
+
+/**
+ * Dirty nodes of one level, updated by level_chunk().
+ */
+struct level {
+    cgm_hierarchy* h;
+    const size_t* nodes;
+    size_t count;
+};
+
+static void level_chunk(void* ctx, size_t begin, size_t end) {
+    const struct level* l = ctx;
+    cgm_hierarchy* h = l->h;
+
+    cgm_mat4 parents[BATCH], locals[BATCH], worlds[BATCH];
+    for (size_t b = begin; b < end; b += BATCH) {
+        size_t count = end - b < BATCH ? end - b : BATCH;
+        const size_t* nodes = &l->nodes[b];
+
+        /* All nodes of a level are roots or none are */
+        if (h->parent[nodes[0]] == CGM_HIERARCHY_ROOT) {
+            for (size_t k = 0; k < count; k++) {
+                local_matrix(&h->world[nodes[k]], h, nodes[k]);
+            }
+            continue;
+        }
+
+        for (size_t k = 0; k < count; k++) {
+            parents[k] = h->world[h->parent[nodes[k]]];
+            local_matrix(&locals[k], h, nodes[k]);
+        }
+
+        cgm_mat4_mul_n(worlds, parents, locals, count);
+
+        for (size_t k = 0; k < count; k++) {
+            h->world[nodes[k]] = worlds[k];
+        }
+    }
+}
+
+static void update_serial(cgm_hierarchy* h) {
+    for (size_t i = 0; i < h->count; i++) {
+        size_t parent = h->parent[i];
+        if (parent != CGM_HIERARCHY_ROOT && h->dirty[parent]) {
+            h->dirty[i] = true;
+        }
+
+        if (!h->dirty[i]) {
+            continue;
+        }
+
+        if (parent == CGM_HIERARCHY_ROOT) {
+            local_matrix(&h->world[i], h, i);
+        } else {
+            cgm_mat4 local;
+            local_matrix(&local, h, i);
+            cgm_mat4_mul(&h->world[i], &h->world[parent], &local);
+        }
+    }
+}
+
+/**
+ * Updates the hierarchy one level at a time.
+ * Returns false, without changing anything, if the grouping cannot be
+ * allocated.
+ */
+static bool update_levels(cgm_hierarchy* h, cgm_pool* pool) {
+    size_t* depth = malloc(h->count * sizeof(size_t));
+    size_t* nodes = malloc(h->count * sizeof(size_t));
+    if (depth == NULL || nodes == NULL) {
+        free(depth);
+        free(nodes);
+        return false;
+    }
+
+    /* Find the depth of each node. Dirty flags are only propagated once
+     * nothing can fail.
+     */
+    size_t levels = 0;
+    for (size_t i = 0; i < h->count; i++) {
+        size_t parent = h->parent[i];
+        depth[i] = parent == CGM_HIERARCHY_ROOT ? 0 : depth[parent] + 1;
+        if (depth[i] >= levels) {
+            levels = depth[i] + 1;
+        }
+    }
+
+    size_t* start = calloc(levels + 1, sizeof(size_t));
+    if (start == NULL) {
+        free(depth);
+        free(nodes);
+        return false;
+    }
+
+    for (size_t i = 0; i < h->count; i++) {
+        size_t parent = h->parent[i];
+        if (parent != CGM_HIERARCHY_ROOT && h->dirty[parent]) {
+            h->dirty[i] = true;
+        }
+
+        if (h->dirty[i]) {
+            start[depth[i] + 1]++;
+        }
+    }
+
+    /* Counting sort of the dirty nodes by depth, keeping index order
+     * within each level
+     */
+    for (size_t d = 0; d < levels; d++) {
+        start[d + 1] += start[d];
+    }
+
+    for (size_t i = 0; i < h->count; i++) {
+        if (h->dirty[i]) {
+            nodes[start[depth[i]]++] = i;
+        }
+    }
+
+    /* Each start has moved up to the next level's */
+    size_t first = 0;
+    for (size_t d = 0; d < levels; d++) {
+        struct level l = {h, &nodes[first], start[d] - first};
+        cgm_parallel_for(pool, l.count, CGM_HIERARCHY_BLOCK, level_chunk, &l);
+        first = start[d];
+    }
+
+    free(depth);
+    free(nodes);
+    free(start);
+    return true;
+}
+
+void cgm_hierarchy_update(cgm_hierarchy* h, cgm_pool* pool) {
+    if (cgm_pool_threads(pool) < 2 || !update_levels(h, pool)) {
+        update_serial(h);
+    }
+
+    /* The flags can only be cleared once every child has seen its
+     * parent's
+     */
+    memset(h->dirty, 0, h->count * sizeof(bool));
+}
+
+/* vim: set ft=c: */
@@ -0,0 +1,177 @@
+/**
+ * hierarchy.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Transform hierarchies: trees of nodes, each with a local translation,
+ * rotation, and scale relative to its parent, from which world matrices
+ * are computed.
+ *
+ * Nodes are stored in topological order (every parent comes before its
+ * children), with the local transforms in structure-of-arrays form, so
+ * that all world matrices are computed in one linear pass. Each node has
+ * a dirty flag, set when its local transform changes; an update only
+ * recomputes dirty nodes and their descendants.
+ */
+
+#ifndef HIERARCHY_H_
+#define HIERARCHY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "vector/vec3.h"
+#include "quaternion/quaternion.h"
+#include "matrix/mat4.h"
+#include "pool.h"
+
+/**
+ * Parent index of a root node.
+ */
+#define CGM_HIERARCHY_ROOT ((size_t) -1)
+
+/**
+ * Number of nodes of one level updated as one chunk of work when spreading
+ * an update over a cgm_pool.
+ */
+#define CGM_HIERARCHY_BLOCK 1024
+
+/**
+ * A transform hierarchy.
+ * The arrays are owned by the hierarchy and may be reallocated when nodes
+ * are added. They may be read directly, but local transforms should be
+ * changed through the cgm_hierarchy_set_*() functions (or followed by
+ * cgm_hierarchy_mark_dirty()) so that the dirty flags are kept.
+ */
+typedef struct cgm_hierarchy {
+    /**
+     * Number of nodes.
+     */
+    size_t count;
+
+    /**
+     * Number of nodes for which space is allocated.
+     */
+    size_t capacity;
+
+    /**
+     * Index of the parent of each node, or CGM_HIERARCHY_ROOT.
+     * parent[i] < i for every non-root node.
+     */
+    size_t* parent;
+
+    /**
+     * Local translation of each node.
+     */
+    cgm_vec3_soa translation;
+
+    /**
+     * Local rotation of each node, as unit quaternions.
+     */
+    cgm_quat_soa rotation;
+
+    /**
+     * Local scale of each node.
+     */
+    cgm_vec3_soa scale;
+
+    /**
+     * World matrix of each node, valid after cgm_hierarchy_update().
+     */
+    cgm_mat4* world;
+
+    /**
+     * Whether each node's local transform has changed since the last
+     * update.
+     */
+    bool* dirty;
+} cgm_hierarchy;
+
+/**
+ * Initializes an empty hierarchy.
+ * @param h - Hierarchy to initialize.
+ * @param capacity - Number of nodes for which to allocate space up front.
+ * @return false if the space could not be allocated, in which case h is
+ *         left empty (and may still be freed).
+ */
+bool cgm_hierarchy_init(cgm_hierarchy* h, size_t capacity);
+
+/**
+ * Frees the arrays of a hierarchy and leaves it empty.
+ * @param h - Hierarchy to free.
+ */
+void cgm_hierarchy_free(cgm_hierarchy* h);
+
+/**
+ * Adds a node to the end of a hierarchy.
+ * The parent must already be in the hierarchy, which keeps the nodes in
+ * topological order. The new node starts out dirty.
+ * @param h - Hierarchy to add to.
+ * @param parent - Index of the parent node, or CGM_HIERARCHY_ROOT.
+ * @param translation - Local translation.
+ * @param rotation - Local rotation (a unit quaternion).
+ * @param scale - Local scale.
+ * @return The index of the new node, or CGM_HIERARCHY_ROOT if parent is
+ *         not a node of h or space could not be allocated.
+ */
+size_t cgm_hierarchy_add(cgm_hierarchy* h, size_t parent,
+        const cgm_vec3* translation,
+        const cgm_quat* rotation,
+        const cgm_vec3* scale);
+
+/**
+ * Sets the local translation of a node and marks it dirty.
+ * @param h - Hierarchy containing the node.
+ * @param i - Index of the node.
+ * @param translation - The translation.
+ */
+void cgm_hierarchy_set_translation(cgm_hierarchy* h, size_t i,
+        const cgm_vec3* translation);
+
+/**
+ * Sets the local rotation of a node and marks it dirty.
+ * @param h - Hierarchy containing the node.
+ * @param i - Index of the node.
+ * @param rotation - The rotation (a unit quaternion).
+ */
+void cgm_hierarchy_set_rotation(cgm_hierarchy* h, size_t i,
+        const cgm_quat* rotation);
+
+/**
+ * Sets the local scale of a node and marks it dirty.
+ * @param h - Hierarchy containing the node.
+ * @param i - Index of the node.
+ * @param scale - The scale.
+ */
+void cgm_hierarchy_set_scale(cgm_hierarchy* h, size_t i,
+        const cgm_vec3* scale);
+
+/**
+ * Marks a node dirty after its local transform was written directly.
+ * @param h - Hierarchy containing the node.
+ * @param i - Index of the node.
+ */
+void cgm_hierarchy_mark_dirty(cgm_hierarchy* h, size_t i);
+
+/**
+ * Recomputes the world matrices of dirty nodes and their descendants,
+ * then clears the dirty flags.
+ * A node's world matrix is its parent's world matrix times its local
+ * matrix T * R * S. Nodes are visited in order, so a dirty flag reaches
+ * every descendant within the same pass and unchanged subtrees are only
+ * read, not recomputed.
+ * With a pool of more than one thread, the dirty nodes are grouped by
+ * depth, and each level (whose nodes only depend on the level above) is
+ * split into chunks of CGM_HIERARCHY_BLOCK nodes spread over the pool. Each
+ * matrix is computed by the same operations either way, so the results
+ * are identical to the serial update. If the grouping cannot be
+ * allocated, the update is done serially.
+ * @param h - Hierarchy to update.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_hierarchy_update(cgm_hierarchy* h, cgm_pool* pool);
+
+#endif /* HIERARCHY_H_ */
+
+/* vim: set ft=c: */
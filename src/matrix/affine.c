@@ -0,0 +1,244 @@
+/**
+ * affine.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "../vector/vec3.h"
+#include "../vector/vec4.h"
+#include "../quaternion/quaternion.h"
+#include "mat4.h"
+#include "affine.h"
+#include "trs.h"
+
+/**
+ * Kernels shared by the single and batch versions.
+ * Transforms are passed by value so that the batch loops can keep them in
+ * registers and so that outputs may alias inputs.
+ */
+static inline cgm_affine mul(cgm_affine a, cgm_affine b) {
+    cgm_affine out;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 4; c++) {
+            out.m[r][c] = a.m[r][0] * b.m[0][c] + a.m[r][1] * b.m[1][c]
+                + a.m[r][2] * b.m[2][c];
+        }
+        out.m[r][3] += a.m[r][3];
+    }
+
+    return out;
+}
+
+/**
+ * With r0, r1, and r2 the rows of the 3x3 block A, the columns of A^-1
+ * are (r1 x r2, r2 x r0, r0 x r1) / det(A).
+ */
+static inline bool invert(cgm_affine* a) {
+    cgm_affine in = *a;
+
+    float c[3][3];
+    for (int i = 0; i < 3; i++) {
+        const float* u = in.m[(i + 1) % 3];
+        const float* v = in.m[(i + 2) % 3];
+        c[i][0] = u[1] * v[2] - u[2] * v[1];
+        c[i][1] = u[2] * v[0] - u[0] * v[2];
+        c[i][2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    float det = in.m[0][0] * c[0][0] + in.m[0][1] * c[0][1]
+        + in.m[0][2] * c[0][2];
+    if (det == 0.0F) {
+        return false;
+    }
+
+    float inv_det = 1.0F / det;
+    for (int r = 0; r < 3; r++) {
+        for (int k = 0; k < 3; k++) {
+            a->m[r][k] = c[k][r] * inv_det;
+        }
+    }
+
+    for (int r = 0; r < 3; r++) {
+        a->m[r][3] = -(a->m[r][0] * in.m[0][3] + a->m[r][1] * in.m[1][3]
+                + a->m[r][2] * in.m[2][3]);
+    }
+
+    return true;
+}
+
+static inline void transform(const cgm_affine* a, float w,
+        float* x, float* y, float* z) {
+    float vx = *x, vy = *y, vz = *z;
+    *x = a->m[0][0] * vx + a->m[0][1] * vy + a->m[0][2] * vz + a->m[0][3] * w;
+    *y = a->m[1][0] * vx + a->m[1][1] * vy + a->m[1][2] * vz + a->m[1][3] * w;
+    *z = a->m[2][0] * vx + a->m[2][1] * vy + a->m[2][2] * vz + a->m[2][3] * w;
+}
+
+static inline cgm_affine from_mat4(const cgm_mat4* m) {
+    cgm_affine a;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 4; c++) {
+            a.m[r][c] = m->m[c][r];
+        }
+    }
+
+    return a;
+}
+
+static inline void to_mat4(cgm_mat4* m, cgm_affine a) {
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 3; r++) {
+            m->m[c][r] = a.m[r][c];
+        }
+        m->m[c][3] = c == 3 ? 1.0F : 0.0F;
+    }
+}
+
+void cgm_affine_set_identity(cgm_affine* a) {
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 4; c++) {
+            a->m[r][c] = r == c ? 1.0F : 0.0F;
+        }
+    }
+}
+
+void cgm_affine_from_mat4(cgm_affine* a, const cgm_mat4* m) {
+    *a = from_mat4(m);
+}
+
+void cgm_affine_to_mat4(cgm_mat4* m, const cgm_affine* a) {
+    to_mat4(m, *a);
+}
+
+void cgm_affine_from_mat4_n(cgm_affine* a, const cgm_mat4* m, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        a[i] = from_mat4(&m[i]);
+    }
+}
+
+void cgm_affine_to_mat4_n(cgm_mat4* m, const cgm_affine* a, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        to_mat4(&m[i], a[i]);
+    }
+}
+
+void cgm_affine_from_quat(cgm_affine* a, const cgm_quat* q) {
+    cgm_vec3 zero, one;
+    cgm_vec3_set(&zero, 0.0F, 0.0F, 0.0F);
+    cgm_vec3_set(&one, 1.0F, 1.0F, 1.0F);
+    cgm_affine_from_trs(a, &zero, q, &one);
+}
+
+void cgm_affine_from_trs(cgm_affine* a, const cgm_vec3* t,
+        const cgm_quat* r, const cgm_vec3* s) {
+    float rs[3][3];
+    cgm_trs_rotation(rs, r->w, r->x, r->y, r->z, s->x, s->y, s->z);
+
+    for (int i = 0; i < 3; i++) {
+        a->m[i][0] = rs[0][i];
+        a->m[i][1] = rs[1][i];
+        a->m[i][2] = rs[2][i];
+    }
+
+    a->m[0][3] = t->x;
+    a->m[1][3] = t->y;
+    a->m[2][3] = t->z;
+}
+
+void cgm_affine_mul(cgm_affine* out, const cgm_affine* a,
+        const cgm_affine* b) {
+    *out = mul(*a, *b);
+}
+
+void cgm_affine_mul_n(cgm_affine* out, const cgm_affine* a,
+        const cgm_affine* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = mul(a[i], b[i]);
+    }
+}
+
+int cgm_affine_invert(cgm_affine* a) {
+    return invert(a);
+}
+
+int cgm_affine_invert_n(cgm_affine* a, size_t n) {
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        ok &= invert(&a[i]);
+    }
+
+    return ok;
+}
+
+void cgm_affine_invert_rigid(cgm_affine* a) {
+    cgm_affine in = *a;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            a->m[r][c] = in.m[c][r];
+        }
+        a->m[r][3] = -(in.m[0][r] * in.m[0][3] + in.m[1][r] * in.m[1][3]
+                + in.m[2][r] * in.m[2][3]);
+    }
+}
+
+void cgm_affine_transform_point(const cgm_affine* a, cgm_vec3* v) {
+    transform(a, 1.0F, &v->x, &v->y, &v->z);
+}
+
+void cgm_affine_transform_dir(const cgm_affine* a, cgm_vec3* v) {
+    transform(a, 0.0F, &v->x, &v->y, &v->z);
+}
+
+void cgm_affine_transform_point_n(const cgm_affine* a, cgm_vec3* v,
+        size_t n) {
+    cgm_affine t = *a;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        transform(&t, 1.0F, &v[i].x, &v[i].y, &v[i].z);
+    }
+}
+
+void cgm_affine_transform_dir_n(const cgm_affine* a, cgm_vec3* v,
+        size_t n) {
+    cgm_affine t = *a;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        transform(&t, 0.0F, &v[i].x, &v[i].y, &v[i].z);
+    }
+}
+
+void cgm_affine_transform_point_soa(const cgm_affine* a, cgm_vec3_soa* v,
+        size_t n) {
+    cgm_affine t = *a;
+    float* x = v->x;
+    float* y = v->y;
+    float* z = v->z;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        transform(&t, 1.0F, &x[i], &y[i], &z[i]);
+    }
+}
+
+int cgm_affine_fprintf(FILE* stream, const cgm_affine* a) {
+    int len = 0;
+    for (int r = 0; r < 3; r++) {
+        len += fprintf(stream, "%g\t%g\t%g\t%g\n",
+                a->m[r][0], a->m[r][1], a->m[r][2], a->m[r][3]);
+    }
+
+    return len;
+}
+
+int cgm_affine_printf(const cgm_affine* a) {
+    return cgm_affine_fprintf(stdout, a);
+}
+
+/* vim: set ft=c: */
@@ -0,0 +1,210 @@
+/**
+ * affine.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Compact affine transforms: the top three rows of a cgm_mat4 whose last
+ * row is (0, 0, 0, 1), in 48 bytes instead of 64.
+ */
+
+#ifndef AFFINE_H_
+#define AFFINE_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "mat4.h"
+#include "../vector/vec3.h"
+#include "../vector/vec4.h"
+#include "../quaternion/quaternion.h"
+
+/**
+ * A 3x4 affine transform.
+ * Unlike the cgm_mat4 arrays, which hold columns, m[r] is row r of the
+ * transform, so that each row is one 16-byte cgm_vec4 and an array of
+ * cgm_affine's can be uploaded as rows of 4 floats. A point p is
+ * transformed to (m[r] . (p, 1)) for each row r.
+ */
+typedef union cgm_affine {
+    /**
+     * Row-major 3x4 2D float array representation of the transform.
+     */
+    float m[3][4];
+
+    /**
+     * 1D float array representation of the transform.
+     */
+    float arr[12];
+
+    /**
+     * 1D array of row cgm_vec4's of the transform.
+     */
+    cgm_vec4 row[3];
+} cgm_affine;
+
+/**
+ * Sets a cgm_affine to the identity transform.
+ * @param a - Transform to set.
+ */
+void cgm_affine_set_identity(cgm_affine* a);
+
+/**
+ * Sets a cgm_affine from the top three rows of a cgm_mat4.
+ * The last row of m is assumed to be (0, 0, 0, 1).
+ * @param a - Transform to set.
+ * @param m - Matrix from which to set.
+ */
+void cgm_affine_from_mat4(cgm_affine* a, const cgm_mat4* m);
+
+/**
+ * Sets a cgm_mat4 from a cgm_affine, with (0, 0, 0, 1) as the last row.
+ * @param m - Matrix to set.
+ * @param a - Transform from which to set.
+ */
+void cgm_affine_to_mat4(cgm_mat4* m, const cgm_affine* a);
+
+/**
+ * Converts an array of cgm_mat4's to cgm_affine's.
+ * @param a - Array of n transforms to set.
+ * @param m - Array of n affine matrices.
+ * @param n - Number of transforms.
+ */
+void cgm_affine_from_mat4_n(cgm_affine* a, const cgm_mat4* m, size_t n);
+
+/**
+ * Expands an array of cgm_affine's to cgm_mat4's, for example to upload
+ * them where full matrices are expected.
+ * @param m - Array of n matrices to set.
+ * @param a - Array of n transforms.
+ * @param n - Number of transforms.
+ */
+void cgm_affine_to_mat4_n(cgm_mat4* m, const cgm_affine* a, size_t n);
+
+/**
+ * Sets a cgm_affine to the rotation of a unit quaternion.
+ * @param a - Transform to set.
+ * @param q - Unit quaternion from which to set.
+ */
+void cgm_affine_from_quat(cgm_affine* a, const cgm_quat* q);
+
+/**
+ * Sets a cgm_affine from a translation, rotation, and scale.
+ * The result is T * R * S: points are scaled, then rotated, then
+ * translated.
+ * @param a - Transform to set.
+ * @param t - The translation.
+ * @param r - The rotation (a unit quaternion).
+ * @param s - The scale.
+ */
+void cgm_affine_from_trs(cgm_affine* a, const cgm_vec3* t,
+        const cgm_quat* r, const cgm_vec3* s);
+
+/**
+ * Composes two cgm_affine's.
+ * The operation `out = a * b' is performed, so out applies b first and
+ * then a. out may be the same as a or b.
+ * @param out - Transform to store the result.
+ * @param a - Transform multiplied on the left.
+ * @param b - Transform multiplied on the right.
+ */
+void cgm_affine_mul(cgm_affine* out, const cgm_affine* a,
+        const cgm_affine* b);
+
+/**
+ * Composes arrays of cgm_affine's pairwise.
+ * out[i] is set to a[i] * b[i]. out may be the same array as a or b.
+ * @param out - Array of n transforms to store the results.
+ * @param a - Array of n transforms multiplied on the left.
+ * @param b - Array of n transforms multiplied on the right.
+ * @param n - Number of transforms.
+ */
+void cgm_affine_mul_n(cgm_affine* out, const cgm_affine* a,
+        const cgm_affine* b, size_t n);
+
+/**
+ * Inverts a cgm_affine.
+ * @param a - Transform to invert.
+ * @return true (1) if the transform could be inverted; false (0)
+ *         otherwise, in which case a is unchanged.
+ */
+int cgm_affine_invert(cgm_affine* a);
+
+/**
+ * Inverts an array of cgm_affine's.
+ * @param a - Array of n transforms to invert.
+ * @param n - Number of transforms.
+ * @return true (1) if every transform could be inverted; false (0)
+ *         otherwise. Transforms which could not be inverted are
+ *         unchanged.
+ */
+int cgm_affine_invert_n(cgm_affine* a, size_t n);
+
+/**
+ * Inverts a rigid cgm_affine (an orthonormal rotation followed by a
+ * translation) by transposing the rotation.
+ * @param a - Transform to invert.
+ */
+void cgm_affine_invert_rigid(cgm_affine* a);
+
+/**
+ * Transforms a point by a cgm_affine.
+ * @param a - Transform to apply.
+ * @param v - Point to transform.
+ */
+void cgm_affine_transform_point(const cgm_affine* a, cgm_vec3* v);
+
+/**
+ * Transforms a direction by a cgm_affine, ignoring the translation.
+ * @param a - Transform to apply.
+ * @param v - Direction to transform.
+ */
+void cgm_affine_transform_dir(const cgm_affine* a, cgm_vec3* v);
+
+/**
+ * Transforms an array of points by one cgm_affine.
+ * @param a - Transform to apply.
+ * @param v - Array of n points to transform.
+ * @param n - Number of points.
+ */
+void cgm_affine_transform_point_n(const cgm_affine* a, cgm_vec3* v,
+        size_t n);
+
+/**
+ * Transforms an array of directions by one cgm_affine, ignoring the
+ * translation.
+ * @param a - Transform to apply.
+ * @param v - Array of n directions to transform.
+ * @param n - Number of directions.
+ */
+void cgm_affine_transform_dir_n(const cgm_affine* a, cgm_vec3* v,
+        size_t n);
+
+/**
+ * Transforms points stored as a structure of arrays by one cgm_affine.
+ * @param a - Transform to apply.
+ * @param v - Arrays of n points to transform.
+ * @param n - Number of points.
+ */
+void cgm_affine_transform_point_soa(const cgm_affine* a, cgm_vec3_soa* v,
+        size_t n);
+
+/**
+ * Prints a cgm_affine to a stream, one row per line, with each element
+ * printed with %g and separated by tabs.
+ * @param stream - Filestream to print to.
+ * @param a - Transform to print.
+ * @return The number of characters printed.
+ */
+int cgm_affine_fprintf(FILE* stream, const cgm_affine* a);
+
+/**
+ * Prints a cgm_affine to stdout.
+ * @param a - Transform to print.
+ * @return The number of characters printed.
+ */
+int cgm_affine_printf(const cgm_affine* a);
+
+#endif /* AFFINE_H_ */
+
+/* vim: set ft=c: */
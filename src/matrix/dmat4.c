@@ -7,6 +7,7 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -14,6 +15,9 @@
 #include "../vector/dvec4.h"
 #include "../quaternion/dquaternion.h"
 #include "dmat4.h"
+#include "shepperd.h"
+
+CGM_SHEPPERD(shepperd, double, cgm_dquat, sqrt)
 
 void cgm_dmat4_fill(cgm_dmat4* m, double val) {
     for (int i = 0; i < 16; i++) {
@@ -60,6 +64,24 @@ void cgm_dmat4_set_dquat(cgm_dmat4* m, const cgm_dquat* q) {
     m->m[3][3] = 1.0F;
 }
 
+static inline cgm_dquat from_dmat4(const cgm_dmat4* m) {
+    return shepperd(
+            m->m[0][0], m->m[0][1], m->m[0][2],
+            m->m[1][0], m->m[1][1], m->m[1][2],
+            m->m[2][0], m->m[2][1], m->m[2][2]);
+}
+
+void cgm_dquat_from_dmat4(cgm_dquat* q, const cgm_dmat4* m) {
+    *q = from_dmat4(m);
+}
+
+void cgm_dquat_from_dmat4_n(cgm_dquat* q, const cgm_dmat4* m, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        q[i] = from_dmat4(&m[i]);
+    }
+}
+
 void cgm_dmat4_set_identity(cgm_dmat4* m) {
     for (int i = 0; i < 16; i++) {
         if (i % 5 == 0) {
@@ -220,6 +242,88 @@ int cgm_dmat4_invert(cgm_dmat4* m) {
 
     cgm_dmat4_scal(&inv, 1 / det);
     cgm_dmat4_cpy(m, &inv);
+    return true;
+}
+
+/**
+ * Inverse kernels shared by the single and batch versions.
+ * With a0, a1, and a2 the columns of the 3x3 block A, the rows of A^-1
+ * are (a1 x a2, a2 x a0, a0 x a1) / det(A).
+ */
+static inline bool invert_affine(cgm_dmat4* m) {
+    double a[3][3], t[3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            a[i][j] = m->m[i][j];
+        }
+        t[i] = m->m[3][i];
+    }
+
+    double r[3][3];
+    for (int i = 0; i < 3; i++) {
+        const double* u = a[(i + 1) % 3];
+        const double* v = a[(i + 2) % 3];
+        r[i][0] = u[1] * v[2] - u[2] * v[1];
+        r[i][1] = u[2] * v[0] - u[0] * v[2];
+        r[i][2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    double det = a[0][0] * r[0][0] + a[0][1] * r[0][1] + a[0][2] * r[0][2];
+    if (det == 0.0) {
+        return false;
+    }
+
+    double inv_det = 1.0 / det;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            m->m[j][i] = r[i][j] * inv_det;
+        }
+        m->m[3][i] = -(r[i][0] * t[0] + r[i][1] * t[1] + r[i][2] * t[2])
+            * inv_det;
+    }
+
+    return true;
+}
+
+static inline void invert_rigid(cgm_dmat4* m) {
+    double t[3] = {m->m[3][0], m->m[3][1], m->m[3][2]};
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = i + 1; j < 3; j++) {
+            double tmp = m->m[i][j];
+            m->m[i][j] = m->m[j][i];
+            m->m[j][i] = tmp;
+        }
+    }
+
+    /* Row i of the transposed block is column i of the original */
+    for (int i = 0; i < 3; i++) {
+        m->m[3][i] = -(m->m[0][i] * t[0] + m->m[1][i] * t[1]
+                + m->m[2][i] * t[2]);
+    }
+}
+
+int cgm_dmat4_invert_affine(cgm_dmat4* m) {
+    return invert_affine(m);
+}
+
+int cgm_dmat4_invert_affine_n(cgm_dmat4* m, size_t n) {
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        ok &= invert_affine(&m[i]);
+    }
+
+    return ok;
+}
+
+void cgm_dmat4_invert_rigid(cgm_dmat4* m) {
+    invert_rigid(m);
+}
+
+void cgm_dmat4_invert_rigid_n(cgm_dmat4* m, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        invert_rigid(&m[i]);
+    }
 }
 
 int cgm_dmat4_fprintf(FILE* stream, const cgm_dmat4* m) {
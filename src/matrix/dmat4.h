@@ -8,6 +8,7 @@
 #ifndef DMAT4_H_
 #define DMAT4_H_
 
+#include <stddef.h>
 #include <stdio.h>
 
 #include "dmat3.h"
@@ -57,6 +58,23 @@ void cgm_dmat4_set_m3(cgm_dmat4* m, const cgm_dmat3* m3);
  */
 void cgm_dmat4_set_dquat(cgm_dmat4* m, const cgm_dquat* q);
 
+/**
+ * Sets a cgm_dquat to the rotation of the upper-left 3x3 block of a
+ * cgm_dmat4, as by cgm_quat_from_mat4().
+ * @param q - Quaternion to set.
+ * @param m - Matrix from which to set.
+ */
+void cgm_dquat_from_dmat4(cgm_dquat* q, const cgm_dmat4* m);
+
+/**
+ * Sets an array of cgm_dquat's to the rotations of an array of
+ * cgm_dmat4's, each as by cgm_dquat_from_dmat4().
+ * @param q - Array of n quaternions to set.
+ * @param m - Array of n matrices.
+ * @param n - Number of matrices.
+ */
+void cgm_dquat_from_dmat4_n(cgm_dquat* q, const cgm_dmat4* m, size_t n);
+
 /**
  * Sets a cgm_dmat4 to an identity matrix.
  * @param m - Matrix to set.
@@ -166,6 +184,45 @@ void cgm_dmat4_transpose(cgm_dmat4* m);
  */
 int cgm_dmat4_invert(cgm_dmat4* m);
 
+/**
+ * Inverts an affine cgm_dmat4.
+ * The last row of m must be (0, 0, 0, 1). Only the upper-left 3x3 block
+ * is inverted (by cofactors), and the translation is transformed by the
+ * result, which is much cheaper than cgm_dmat4_invert().
+ * @param m - Matrix to invert.
+ * @return true (1) if the matrix could be inverted; false (0) otherwise,
+ *         in which case m is unchanged.
+ */
+int cgm_dmat4_invert_affine(cgm_dmat4* m);
+
+/**
+ * Inverts an array of affine cgm_dmat4's.
+ * Each matrix is inverted as by cgm_dmat4_invert_affine().
+ * @param m - Array of n matrices to invert.
+ * @param n - Number of matrices.
+ * @return true (1) if every matrix could be inverted; false (0)
+ *         otherwise. Matrices which could not be inverted are unchanged.
+ */
+int cgm_dmat4_invert_affine_n(cgm_dmat4* m, size_t n);
+
+/**
+ * Inverts a rigid cgm_dmat4 (a rotation followed by a translation), such as a
+ * view matrix.
+ * The upper-left 3x3 block of m must be orthonormal and the last row must
+ * be (0, 0, 0, 1). The rotation is transposed and the translation rotated
+ * back, so no division is needed.
+ * @param m - Matrix to invert.
+ */
+void cgm_dmat4_invert_rigid(cgm_dmat4* m);
+
+/**
+ * Inverts an array of rigid cgm_dmat4's.
+ * Each matrix is inverted as by cgm_dmat4_invert_rigid().
+ * @param m - Array of n matrices to invert.
+ * @param n - Number of matrices.
+ */
+void cgm_dmat4_invert_rigid_n(cgm_dmat4* m, size_t n);
+
 /**
  * Prints a cgm_dmat4 to a stream.
  * The matrix is printed as:
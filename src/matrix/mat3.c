@@ -7,11 +7,16 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "../vector/vec3.h"
+#include "../quaternion/quaternion.h"
 #include "mat3.h"
+#include "shepperd.h"
+
+CGM_SHEPPERD(shepperd, float, cgm_quat, sqrtf)
 
 void cgm_mat3_fill(cgm_mat3* m, float val) {
     for (int i = 0; i < 9; i++) {
@@ -133,6 +138,24 @@ int cgm_mat3_invert(cgm_mat3* m) {
     return true;
 }
 
+static inline cgm_quat from_mat3(const cgm_mat3* m) {
+    return shepperd(
+            m->m[0][0], m->m[0][1], m->m[0][2],
+            m->m[1][0], m->m[1][1], m->m[1][2],
+            m->m[2][0], m->m[2][1], m->m[2][2]);
+}
+
+void cgm_quat_from_mat3(cgm_quat* q, const cgm_mat3* m) {
+    *q = from_mat3(m);
+}
+
+void cgm_quat_from_mat3_n(cgm_quat* q, const cgm_mat3* m, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        q[i] = from_mat3(&m[i]);
+    }
+}
+
 int cgm_mat3_fprintf(FILE* stream, const cgm_mat3* m) {
     int len = 0;
     for (int i = 0; i < 3; i++) {
@@ -9,9 +9,11 @@
 #define MAT3_H_
 
 #include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 
 #include "../vector/vec3.h"
+#include "../quaternion/quaternion.h"
 
 /**
  * A 3x3 matrix with float elements.
@@ -135,6 +137,25 @@ void cgm_mat3_transpose(cgm_mat3* m);
  */
 int cgm_mat3_invert(cgm_mat3* m);
 
+/**
+ * Sets a quaternion to the rotation of a cgm_mat3.
+ * The matrix should be a rotation (orthonormal with determinant 1); the
+ * result is a unit quaternion with w >= 0, so that equal rotations give
+ * equal quaternions. This is the inverse of cgm_mat4_set_quat().
+ * @param q - Quaternion to set.
+ * @param m - Rotation matrix from which to set.
+ */
+void cgm_quat_from_mat3(cgm_quat* q, const cgm_mat3* m);
+
+/**
+ * Sets an array of quaternions to the rotations of an array of cgm_mat3's,
+ * each as by cgm_quat_from_mat3().
+ * @param q - Array of n quaternions to set.
+ * @param m - Array of n rotation matrices.
+ * @param n - Number of matrices.
+ */
+void cgm_quat_from_mat3_n(cgm_quat* q, const cgm_mat3* m, size_t n);
+
 /**
  * Prints a cgm_mat3 to a stream.
  * The matrix is printed as:
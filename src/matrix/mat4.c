@@ -7,12 +7,20 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "../vector/vec3.h"
 #include "../vector/vec4.h"
+#include "../vector/half.h"
+#include "../vector/hvec3.h"
+#include "../vector/hvec4.h"
 #include "mat4.h"
+#include "shepperd.h"
+#include "trs.h"
+
+CGM_SHEPPERD(shepperd, float, cgm_quat, sqrtf)
 
 void cgm_mat4_fill(cgm_mat4* m, float val) {
     for (int i = 0; i < 16; i++) {
@@ -27,38 +35,225 @@ void cgm_mat4_set_m3(cgm_mat4* m, const cgm_mat3* m3) {
     cgm_vec4_set(&m->vec[3], 0.0F, 0.0F, 0.0F, 1.0F);
 }
 
-void cgm_mat4_set_quat(cgm_mat4* m, const cgm_quat* q) {
-    float xx = q->x * q->x;
-    float yy = q->y * q->y;
-    float zz = q->z * q->z;
-    float xz = q->x * q->z;
-    float xy = q->x * q->y;
-    float yz = q->y * q->z;
-    float wx = q->w * q->x;
-    float wy = q->w * q->y;
-    float wz = q->w * q->z;
-
-    m->m[0][0] = 1.0F - 2.0F * (yy +  zz);
-    m->m[0][1] = 2.0F * (xy + wz);
-    m->m[0][2] = 2.0F * (xz - wy);
-    m->m[0][3] = 0.0F;
-
-    m->m[1][0] = 2.0F * (xy - wz);
-    m->m[1][1] = 1.0F - 2.0F * (xx +  zz);
-    m->m[1][2] = 2.0F * (yz + wx);
-    m->m[1][3] = 0.0F;
-
-    m->m[2][0] = 2.0F * (xz + wy);
-    m->m[2][1] = 2.0F * (yz - wx);
-    m->m[2][2] = 1.0F - 2.0F * (xx +  yy);
-    m->m[2][3] = 0.0F;
-
-    m->m[3][0] = 0.0F;
-    m->m[3][1] = 0.0F;
-    m->m[3][2] = 0.0F;
+/**
+ * Sets m to T * R * S, with R the rotation of the unit quaternion
+ * (w, x, y, z). The translation goes straight into the last column.
+ */
+static inline void trs(cgm_mat4* m,
+        float tx, float ty, float tz,
+        float w, float x, float y, float z,
+        float sx, float sy, float sz) {
+    float rs[3][3];
+    cgm_trs_rotation(rs, w, x, y, z, sx, sy, sz);
+
+    for (int c = 0; c < 3; c++) {
+        m->m[c][0] = rs[c][0];
+        m->m[c][1] = rs[c][1];
+        m->m[c][2] = rs[c][2];
+        m->m[c][3] = 0.0F;
+    }
+
+    m->m[3][0] = tx;
+    m->m[3][1] = ty;
+    m->m[3][2] = tz;
     m->m[3][3] = 1.0F;
 }
 
+void cgm_mat4_set_quat(cgm_mat4* m, const cgm_quat* q) {
+    trs(m, 0.0F, 0.0F, 0.0F, q->w, q->x, q->y, q->z, 1.0F, 1.0F, 1.0F);
+}
+
+void cgm_mat4_from_trs(cgm_mat4* m, const cgm_vec3* t,
+        const cgm_quat* r, const cgm_vec3* s) {
+    trs(m, t->x, t->y, t->z, r->w, r->x, r->y, r->z, s->x, s->y, s->z);
+}
+
+void cgm_mat4_from_trs_n(cgm_mat4* m, const cgm_vec3* t,
+        const cgm_quat* r, const cgm_vec3* s, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        trs(&m[i], t[i].x, t[i].y, t[i].z,
+                r[i].w, r[i].x, r[i].y, r[i].z,
+                s[i].x, s[i].y, s[i].z);
+    }
+}
+
+void cgm_mat4_soa_from_trs(cgm_mat4* m, const cgm_vec3_soa* t,
+        const cgm_quat_soa* r, const cgm_vec3_soa* s, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        trs(&m[i], t->x[i], t->y[i], t->z[i],
+                r->w[i], r->x[i], r->y[i], r->z[i],
+                s->x[i], s->y[i], s->z[i]);
+    }
+}
+
+static inline cgm_quat from_mat4(const cgm_mat4* m) {
+    return shepperd(
+            m->m[0][0], m->m[0][1], m->m[0][2],
+            m->m[1][0], m->m[1][1], m->m[1][2],
+            m->m[2][0], m->m[2][1], m->m[2][2]);
+}
+
+void cgm_quat_from_mat4(cgm_quat* q, const cgm_mat4* m) {
+    *q = from_mat4(m);
+}
+
+void cgm_quat_from_mat4_n(cgm_quat* q, const cgm_mat4* m, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        q[i] = from_mat4(&m[i]);
+    }
+}
+
+void cgm_quat_soa_from_mat4(cgm_quat_soa* q, const cgm_mat4* m, size_t n) {
+    float* qw = q->w;
+    float* qx = q->x;
+    float* qy = q->y;
+    float* qz = q->z;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_quat r = from_mat4(&m[i]);
+        qw[i] = r.w;
+        qx[i] = r.x;
+        qy[i] = r.y;
+        qz[i] = r.z;
+    }
+}
+
+static inline float dot3(const float* u, const float* v) {
+    return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+}
+
+/**
+ * Orthonormalizes the columns c by Gram-Schmidt, storing their scales in
+ * s and the projections removed (the shear, relative to the scales) in
+ * h. Returns false if a column is 0 or depends on the earlier ones.
+ */
+static inline bool orthonormalize(float c[3][3], float* s, float* h) {
+    s[0] = sqrtf(dot3(c[0], c[0]));
+    if (s[0] == 0.0F) {
+        return false;
+    }
+    for (int j = 0; j < 3; j++) {
+        c[0][j] /= s[0];
+    }
+
+    h[0] = dot3(c[0], c[1]);
+    for (int j = 0; j < 3; j++) {
+        c[1][j] -= h[0] * c[0][j];
+    }
+    s[1] = sqrtf(dot3(c[1], c[1]));
+    if (s[1] == 0.0F) {
+        return false;
+    }
+    for (int j = 0; j < 3; j++) {
+        c[1][j] /= s[1];
+    }
+
+    h[1] = dot3(c[0], c[2]);
+    h[2] = dot3(c[1], c[2]);
+    for (int j = 0; j < 3; j++) {
+        c[2][j] -= h[1] * c[0][j] + h[2] * c[1][j];
+    }
+    s[2] = sqrtf(dot3(c[2], c[2]));
+    if (s[2] == 0.0F) {
+        return false;
+    }
+    for (int j = 0; j < 3; j++) {
+        c[2][j] /= s[2];
+    }
+
+    h[0] /= s[1];
+    h[1] /= s[2];
+    h[2] /= s[2];
+    return true;
+}
+
+/**
+ * Decomposition kernel shared by the single and batch versions.
+ * t, s, and h (shear) are arrays of 3; r is the rotation.
+ */
+static inline bool decompose(const cgm_mat4* m,
+        float* t, cgm_quat* r, float* s, float* h) {
+    float c[3][3];
+    for (int i = 0; i < 3; i++) {
+        t[i] = m->m[3][i];
+        for (int j = 0; j < 3; j++) {
+            c[i][j] = m->m[i][j];
+        }
+    }
+
+    if (!orthonormalize(c, s, h)) {
+        for (int i = 0; i < 3; i++) {
+            s[i] = sqrtf(dot3(m->m[i], m->m[i]));
+            h[i] = 0.0F;
+        }
+        cgm_quat_set_identity(r);
+        return false;
+    }
+
+    /* A reflection is taken as a negative scale on all axes */
+    float cross[3] = {
+        c[1][1] * c[2][2] - c[1][2] * c[2][1],
+        c[1][2] * c[2][0] - c[1][0] * c[2][2],
+        c[1][0] * c[2][1] - c[1][1] * c[2][0],
+    };
+    if (dot3(c[0], cross) < 0.0F) {
+        for (int i = 0; i < 3; i++) {
+            s[i] = -s[i];
+            for (int j = 0; j < 3; j++) {
+                c[i][j] = -c[i][j];
+            }
+        }
+    }
+
+    *r = shepperd(c[0][0], c[0][1], c[0][2],
+            c[1][0], c[1][1], c[1][2],
+            c[2][0], c[2][1], c[2][2]);
+    return true;
+}
+
+bool cgm_mat4_decompose(const cgm_mat4* m, cgm_vec3* t, cgm_quat* r,
+        cgm_vec3* s, cgm_vec3* shear) {
+    float h[3];
+    bool ok = decompose(m, t->v, r, s->v, h);
+    if (shear != NULL) {
+        cgm_vec3_set(shear, h[0], h[1], h[2]);
+    }
+
+    return ok;
+}
+
+bool cgm_mat4_decompose_soa(const cgm_mat4* m, cgm_vec3_soa* t,
+        cgm_quat_soa* r, cgm_vec3_soa* s, cgm_vec3_soa* shear, size_t n) {
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        float tv[3], sv[3], h[3];
+        cgm_quat q;
+        ok &= decompose(&m[i], tv, &q, sv, h);
+
+        t->x[i] = tv[0];
+        t->y[i] = tv[1];
+        t->z[i] = tv[2];
+        r->w[i] = q.w;
+        r->x[i] = q.x;
+        r->y[i] = q.y;
+        r->z[i] = q.z;
+        s->x[i] = sv[0];
+        s->y[i] = sv[1];
+        s->z[i] = sv[2];
+        if (shear != NULL) {
+            shear->x[i] = h[0];
+            shear->y[i] = h[1];
+            shear->z[i] = h[2];
+        }
+    }
+
+    return ok;
+}
+
 void cgm_mat4_set_identity(cgm_mat4* m) {
     for (int i = 0; i < 16; i++) {
         if (i % 5 == 0) {
@@ -101,7 +296,11 @@ void cgm_mat4_scal(cgm_mat4* m, float val) {
     }
 }
 
-void cgm_mat4_mul(cgm_mat4* out, const cgm_mat4* a, const cgm_mat4* b) {
+/**
+ * Shared by the single and batch products so that both round the same
+ * way.
+ */
+static inline void mul(cgm_mat4* out, const cgm_mat4* a, const cgm_mat4* b) {
     cgm_mat4_fill(out, 0);
     for (int i = 0; i < 4; i++) {
         for (int k = 0; k < 4; k++) {
@@ -113,6 +312,17 @@ void cgm_mat4_mul(cgm_mat4* out, const cgm_mat4* a, const cgm_mat4* b) {
     }
 }
 
+void cgm_mat4_mul(cgm_mat4* out, const cgm_mat4* a, const cgm_mat4* b) {
+    mul(out, a, b);
+}
+
+void cgm_mat4_mul_n(cgm_mat4* out, const cgm_mat4* a, const cgm_mat4* b,
+        size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        mul(&out[i], &a[i], &b[i]);
+    }
+}
+
 void cgm_mat4_mul_l(cgm_mat4* a, const cgm_mat4* b) {
     cgm_mat4 out;
     cgm_mat4_mul(&out, a, b);
@@ -140,6 +350,68 @@ void cgm_mat4_mul_v4(const cgm_mat4* m, cgm_vec4* v) {
     v->w = m->m[0][3] * x + m->m[1][3] * y + m->m[2][3] * z + m->m[3][3] * w;
 }
 
+/**
+ * Number of half vectors widened to float at a time on the stack, small
+ * enough to stay in L1.
+ */
+#define HALF_BLOCK 256
+
+static inline void mul_v3_block(const cgm_mat4* m, float* v, float w,
+        size_t n) {
+    cgm_mat4 t = *m;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        float x = v[3 * i], y = v[3 * i + 1], z = v[3 * i + 2];
+        v[3 * i] = t.m[0][0] * x + t.m[1][0] * y + t.m[2][0] * z
+            + t.m[3][0] * w;
+        v[3 * i + 1] = t.m[0][1] * x + t.m[1][1] * y + t.m[2][1] * z
+            + t.m[3][1] * w;
+        v[3 * i + 2] = t.m[0][2] * x + t.m[1][2] * y + t.m[2][2] * z
+            + t.m[3][2] * w;
+    }
+}
+
+static inline void mul_hv3_n(const cgm_mat4* m, cgm_hvec3* v, float w,
+        size_t n) {
+    float block[3 * HALF_BLOCK];
+    for (size_t i = 0; i < n; i += HALF_BLOCK) {
+        size_t k = n - i < HALF_BLOCK ? n - i : HALF_BLOCK;
+        cgm_half_to_float_n(block, v[i].v, 3 * k);
+        mul_v3_block(m, block, w, k);
+        cgm_half_from_float_n(v[i].v, block, 3 * k);
+    }
+}
+
+void cgm_mat4_mul_hv3_n(const cgm_mat4* m, cgm_hvec3* v, size_t n) {
+    mul_hv3_n(m, v, 1.0F, n);
+}
+
+void cgm_mat4_mul_hv3_dir_n(const cgm_mat4* m, cgm_hvec3* v, size_t n) {
+    mul_hv3_n(m, v, 0.0F, n);
+}
+
+void cgm_mat4_mul_hv4_n(const cgm_mat4* m, cgm_hvec4* v, size_t n) {
+    cgm_mat4 t = *m;
+    float block[4 * HALF_BLOCK];
+    for (size_t i = 0; i < n; i += HALF_BLOCK) {
+        size_t k = n - i < HALF_BLOCK ? n - i : HALF_BLOCK;
+        cgm_half_to_float_n(block, v[i].v, 4 * k);
+
+        #pragma omp simd
+        for (size_t j = 0; j < k; j++) {
+            float* b = &block[4 * j];
+            float x = b[0], y = b[1], z = b[2], w = b[3];
+            for (int r = 0; r < 4; r++) {
+                b[r] = t.m[0][r] * x + t.m[1][r] * y + t.m[2][r] * z
+                    + t.m[3][r] * w;
+            }
+        }
+
+        cgm_half_from_float_n(v[i].v, block, 4 * k);
+    }
+}
+
 void cgm_mat4_mul_quat(cgm_mat4* m, const cgm_quat* q) {
     cgm_mat4 tmp;
     cgm_mat4_set_quat(&tmp, q);
@@ -219,6 +491,88 @@ int cgm_mat4_invert(cgm_mat4* m) {
 
     cgm_mat4_scal(&inv, 1 / det);
     cgm_mat4_cpy(m, &inv);
+    return true;
+}
+
+/**
+ * Inverse kernels shared by the single and batch versions.
+ * With a0, a1, and a2 the columns of the 3x3 block A, the rows of A^-1
+ * are (a1 x a2, a2 x a0, a0 x a1) / det(A).
+ */
+static inline bool invert_affine(cgm_mat4* m) {
+    float a[3][3], t[3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            a[i][j] = m->m[i][j];
+        }
+        t[i] = m->m[3][i];
+    }
+
+    float r[3][3];
+    for (int i = 0; i < 3; i++) {
+        const float* u = a[(i + 1) % 3];
+        const float* v = a[(i + 2) % 3];
+        r[i][0] = u[1] * v[2] - u[2] * v[1];
+        r[i][1] = u[2] * v[0] - u[0] * v[2];
+        r[i][2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    float det = a[0][0] * r[0][0] + a[0][1] * r[0][1] + a[0][2] * r[0][2];
+    if (det == 0.0F) {
+        return false;
+    }
+
+    float inv_det = 1.0F / det;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            m->m[j][i] = r[i][j] * inv_det;
+        }
+        m->m[3][i] = -(r[i][0] * t[0] + r[i][1] * t[1] + r[i][2] * t[2])
+            * inv_det;
+    }
+
+    return true;
+}
+
+static inline void invert_rigid(cgm_mat4* m) {
+    float t[3] = {m->m[3][0], m->m[3][1], m->m[3][2]};
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = i + 1; j < 3; j++) {
+            float tmp = m->m[i][j];
+            m->m[i][j] = m->m[j][i];
+            m->m[j][i] = tmp;
+        }
+    }
+
+    /* Row i of the transposed block is column i of the original */
+    for (int i = 0; i < 3; i++) {
+        m->m[3][i] = -(m->m[0][i] * t[0] + m->m[1][i] * t[1]
+                + m->m[2][i] * t[2]);
+    }
+}
+
+int cgm_mat4_invert_affine(cgm_mat4* m) {
+    return invert_affine(m);
+}
+
+int cgm_mat4_invert_affine_n(cgm_mat4* m, size_t n) {
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        ok &= invert_affine(&m[i]);
+    }
+
+    return ok;
+}
+
+void cgm_mat4_invert_rigid(cgm_mat4* m) {
+    invert_rigid(m);
+}
+
+void cgm_mat4_invert_rigid_n(cgm_mat4* m, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        invert_rigid(&m[i]);
+    }
 }
 
 int cgm_mat4_fprintf(FILE* stream, const cgm_mat4* m) {
@@ -8,11 +8,14 @@
 #ifndef MAT4_H_
 #define MAT4_H_
 
+#include <stddef.h>
 #include <stdio.h>
 
 #include "mat3.h"
 #include "../vector/vec3.h"
 #include "../vector/vec4.h"
+#include "../vector/hvec3.h"
+#include "../vector/hvec4.h"
 #include "../quaternion/quaternion.h"
 
 /**
@@ -57,6 +60,117 @@ void cgm_mat4_set_m3(cgm_mat4* m, const cgm_mat3* m3);
  */
 void cgm_mat4_set_quat(cgm_mat4* m, const cgm_quat* q);
 
+/**
+ * Sets a quaternion to the rotation of the upper-left 3x3 block of a
+ * cgm_mat4, as by cgm_quat_from_mat3(). The rest of the matrix is ignored.
+ * @param q - Quaternion to set.
+ * @param m - Matrix from which to set.
+ */
+void cgm_quat_from_mat4(cgm_quat* q, const cgm_mat4* m);
+
+/**
+ * Sets an array of quaternions to the rotations of an array of cgm_mat4's,
+ * each as by cgm_quat_from_mat4().
+ * @param q - Array of n quaternions to set.
+ * @param m - Array of n matrices.
+ * @param n - Number of matrices.
+ */
+void cgm_quat_from_mat4_n(cgm_quat* q, const cgm_mat4* m, size_t n);
+
+/**
+ * Sets quaternions stored as a structure of arrays to the rotations of an
+ * array of cgm_mat4's, each as by cgm_quat_from_mat4().
+ * @param q - Arrays of n quaternions to set.
+ * @param m - Array of n matrices.
+ * @param n - Number of matrices.
+ */
+void cgm_quat_soa_from_mat4(cgm_quat_soa* q, const cgm_mat4* m, size_t n);
+
+/**
+ * Sets a cgm_mat4 from a translation, rotation, and scale.
+ * The result is T * R * S (points are scaled, then rotated, then
+ * translated), the same as cgm_set_translate(), cgm_mat4_mul_quat(), and
+ * cgm_scale() in turn, but written directly without any multiplies.
+ * @param m - Matrix to set.
+ * @param t - The translation.
+ * @param r - The rotation (a unit quaternion).
+ * @param s - The scale.
+ */
+void cgm_mat4_from_trs(cgm_mat4* m, const cgm_vec3* t,
+        const cgm_quat* r, const cgm_vec3* s);
+
+/**
+ * Sets an array of cgm_mat4's from arrays of translations, rotations, and
+ * scales.
+ * m[i] is set as by cgm_mat4_from_trs() from t[i], r[i], and s[i].
+ * @param m - Array of n matrices to set.
+ * @param t - Array of n translations.
+ * @param r - Array of n rotations (unit quaternions).
+ * @param s - Array of n scales.
+ * @param n - Number of matrices.
+ */
+void cgm_mat4_from_trs_n(cgm_mat4* m, const cgm_vec3* t,
+        const cgm_quat* r, const cgm_vec3* s, size_t n);
+
+/**
+ * Sets an array of cgm_mat4's from translations, rotations, and scales
+ * stored as structures of arrays.
+ * This is the SoA form of cgm_mat4_from_trs_n().
+ * @param m - Array of n matrices to set.
+ * @param t - Arrays of n translations.
+ * @param r - Arrays of n rotations (unit quaternions).
+ * @param s - Arrays of n scales.
+ * @param n - Number of matrices.
+ */
+void cgm_mat4_soa_from_trs(cgm_mat4* m, const cgm_vec3_soa* t,
+        const cgm_quat_soa* r, const cgm_vec3_soa* s, size_t n);
+
+/**
+ * Decomposes an affine cgm_mat4 into translation, rotation, scale, and
+ * shear.
+ * The upper-left 3x3 block is factored as R * H * S by Gram-Schmidt
+ * orthogonalization of its columns, where S is the diagonal scale and H
+ * is the shear
+ *      1   shear.x shear.y
+ *      0   1       shear.z
+ *      0   0       1
+ * (x against y, x against z, and y against z). With no shear, H is the
+ * identity and m = T * R * S, as built by cgm_mat4_from_trs(). A
+ * reflection is returned as a negative scale on all three axes. The
+ * rotation has a non-negative w.
+ * If a column is 0 or depends on the earlier ones, the matrix cannot be
+ * decomposed: t is still set, s is set to the lengths of the columns,
+ * shear to 0, and r to the identity.
+ * The last row of m is assumed to be (0, 0, 0, 1).
+ * @param m - Matrix to decompose.
+ * @param t - Vector to store the translation.
+ * @param r - Quaternion to store the rotation.
+ * @param s - Vector to store the scale.
+ * @param shear - Vector to store the shear, or NULL to ignore it (in
+ *                which case a sheared matrix is not reproduced by
+ *                cgm_mat4_from_trs()).
+ * @return true (1) if the matrix could be decomposed; false (0)
+ *         otherwise.
+ */
+bool cgm_mat4_decompose(const cgm_mat4* m, cgm_vec3* t, cgm_quat* r,
+        cgm_vec3* s, cgm_vec3* shear);
+
+/**
+ * Decomposes an array of cgm_mat4's into translations, rotations,
+ * scales, and shears stored as structures of arrays.
+ * Each matrix is decomposed as by cgm_mat4_decompose().
+ * @param m - Array of n matrices to decompose.
+ * @param t - Arrays of n translations to set.
+ * @param r - Arrays of n rotations to set.
+ * @param s - Arrays of n scales to set.
+ * @param shear - Arrays of n shears to set, or NULL.
+ * @param n - Number of matrices.
+ * @return true (1) if every matrix could be decomposed; false (0)
+ *         otherwise.
+ */
+bool cgm_mat4_decompose_soa(const cgm_mat4* m, cgm_vec3_soa* t,
+        cgm_quat_soa* r, cgm_vec3_soa* s, cgm_vec3_soa* shear, size_t n);
+
 /**
  * Sets a cgm_mat4 to an identity matrix.
  * @param m - Matrix to set.
@@ -109,6 +223,18 @@ void cgm_mat4_scal(cgm_mat4* m, float val);
  */
 void cgm_mat4_mul(cgm_mat4* out, const cgm_mat4* a, const cgm_mat4* b);
 
+/**
+ * Multiplies arrays of cgm_mat4's pairwise.
+ * out[i] is set to a[i] * b[i], with the same rounding as cgm_mat4_mul().
+ * out must not overlap a or b.
+ * @param out - Array of n matrices to store the results.
+ * @param a - Array of n matrices to multiply on the left.
+ * @param b - Array of n matrices to multiply on the right.
+ * @param n - Number of products.
+ */
+void cgm_mat4_mul_n(cgm_mat4* out, const cgm_mat4* a, const cgm_mat4* b,
+        size_t n);
+
 /**
  * Multiplies two cgm_mat4's.
  * @param a - Matrix to multiply on the left and store the result.
@@ -137,6 +263,36 @@ void cgm_mat4_mul_v3(const cgm_mat4* m, cgm_vec3* v);
  */
 void cgm_mat4_mul_v4(const cgm_mat4* m, cgm_vec4* v);
 
+/**
+ * Multiplies an array of cgm_hvec3's by a cgm_mat4 as points, as by
+ * cgm_mat4_mul_v3(). The vectors are widened, transformed, and rounded
+ * back to half precision a block at a time, so no float copy of the
+ * array is needed.
+ * @param m - Matrix to multiply by (on the left).
+ * @param v - Array of n vectors to multiply (on the right).
+ * @param n - Number of vectors.
+ */
+void cgm_mat4_mul_hv3_n(const cgm_mat4* m, cgm_hvec3* v, size_t n);
+
+/**
+ * Multiplies an array of cgm_hvec3's by a cgm_mat4 as directions, with a
+ * w component of 0, as cgm_mat4_mul_hv3_n() does for points. For
+ * normals, m should be the inverse transpose of the model matrix.
+ * @param m - Matrix to multiply by (on the left).
+ * @param v - Array of n vectors to multiply (on the right).
+ * @param n - Number of vectors.
+ */
+void cgm_mat4_mul_hv3_dir_n(const cgm_mat4* m, cgm_hvec3* v, size_t n);
+
+/**
+ * Multiplies an array of cgm_hvec4's by a cgm_mat4, as by
+ * cgm_mat4_mul_v4(), a block at a time as for cgm_mat4_mul_hv3_n().
+ * @param m - Matrix to multiply by (on the left).
+ * @param v - Array of n vectors to multiply (on the right).
+ * @param n - Number of vectors.
+ */
+void cgm_mat4_mul_hv4_n(const cgm_mat4* m, cgm_hvec4* v, size_t n);
+
 /**
  * Applies the rotation from a cgm_quat to a cgm_mat4.
  * @param m - Matrix to rotate.
@@ -166,6 +322,45 @@ void cgm_mat4_transpose(cgm_mat4* m);
  */
 int cgm_mat4_invert(cgm_mat4* m);
 
+/**
+ * Inverts an affine cgm_mat4.
+ * The last row of m must be (0, 0, 0, 1). Only the upper-left 3x3 block
+ * is inverted (by cofactors), and the translation is transformed by the
+ * result, which is much cheaper than cgm_mat4_invert().
+ * @param m - Matrix to invert.
+ * @return true (1) if the matrix could be inverted; false (0) otherwise,
+ *         in which case m is unchanged.
+ */
+int cgm_mat4_invert_affine(cgm_mat4* m);
+
+/**
+ * Inverts an array of affine cgm_mat4's.
+ * Each matrix is inverted as by cgm_mat4_invert_affine().
+ * @param m - Array of n matrices to invert.
+ * @param n - Number of matrices.
+ * @return true (1) if every matrix could be inverted; false (0)
+ *         otherwise. Matrices which could not be inverted are unchanged.
+ */
+int cgm_mat4_invert_affine_n(cgm_mat4* m, size_t n);
+
+/**
+ * Inverts a rigid cgm_mat4 (a rotation followed by a translation), such as a
+ * view matrix.
+ * The upper-left 3x3 block of m must be orthonormal and the last row must
+ * be (0, 0, 0, 1). The rotation is transposed and the translation rotated
+ * back, so no division is needed.
+ * @param m - Matrix to invert.
+ */
+void cgm_mat4_invert_rigid(cgm_mat4* m);
+
+/**
+ * Inverts an array of rigid cgm_mat4's.
+ * Each matrix is inverted as by cgm_mat4_invert_rigid().
+ * @param m - Array of n matrices to invert.
+ * @param n - Number of matrices.
+ */
+void cgm_mat4_invert_rigid_n(cgm_mat4* m, size_t n);
+
 /**
  * Prints a cgm_mat4 to a stream.
  * The matrix is printed as:
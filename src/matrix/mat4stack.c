@@ -0,0 +1,235 @@
+/**
+ * mat4stack.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "../vector/vec3.h"
+#include "../sincos.h"
+#include "mat3.h"
+#include "mat4.h"
+#include "mat4stack.h"
+
+#define INVERSE_VALID 1U
+#define NORMAL_VALID 2U
+
+/**
+ * Gets the top level of a stack and invalidates its caches, for
+ * functions which change it.
+ */
+static inline cgm_mat4_stack_entry* modify_top(cgm_mat4_stack* s) {
+    cgm_mat4_stack_entry* e = &s->entries[s->top];
+    e->valid = 0;
+    return e;
+}
+
+/**
+ * Replaces columns a and b of m with `c a - s b' and `s a + c b', which
+ * is m times a rotation in the plane of those axes.
+ */
+static inline void rotate_columns(cgm_mat4* m, int a, int b,
+        float s, float c) {
+    for (int j = 0; j < 4; j++) {
+        float ma = m->m[a][j], mb = m->m[b][j];
+        m->m[a][j] = c * ma - s * mb;
+        m->m[b][j] = s * ma + c * mb;
+    }
+}
+
+bool cgm_mat4_stack_init(cgm_mat4_stack* s, size_t capacity) {
+    if (capacity == 0) {
+        capacity = 1;
+    }
+
+    s->entries = aligned_alloc(_Alignof(cgm_mat4_stack_entry),
+            capacity * sizeof(cgm_mat4_stack_entry));
+    s->capacity = s->entries == NULL ? 0 : capacity;
+    s->top = 0;
+    if (s->entries == NULL) {
+        return false;
+    }
+
+    cgm_mat4_stack_load_identity(s);
+    return true;
+}
+
+void cgm_mat4_stack_free(cgm_mat4_stack* s) {
+    free(s->entries);
+    s->entries = NULL;
+    s->capacity = 0;
+    s->top = 0;
+}
+
+bool cgm_mat4_stack_push(cgm_mat4_stack* s) {
+    if (s->top + 1 >= s->capacity) {
+        return false;
+    }
+
+    const cgm_mat4_stack_entry* src = &s->entries[s->top];
+    cgm_mat4_stack_entry* dest = &s->entries[++s->top];
+
+    /* Only copy the caches that hold something */
+    dest->m = src->m;
+    dest->valid = src->valid;
+    if (src->valid & INVERSE_VALID) {
+        dest->inverse = src->inverse;
+    }
+    if (src->valid & NORMAL_VALID) {
+        dest->normal = src->normal;
+    }
+
+    return true;
+}
+
+bool cgm_mat4_stack_pop(cgm_mat4_stack* s) {
+    if (s->top == 0) {
+        return false;
+    }
+
+    s->top--;
+    return true;
+}
+
+const cgm_mat4* cgm_mat4_stack_top(const cgm_mat4_stack* s) {
+    return &s->entries[s->top].m;
+}
+
+const cgm_mat4* cgm_mat4_stack_inverse(cgm_mat4_stack* s) {
+    cgm_mat4_stack_entry* e = &s->entries[s->top];
+    if (!(e->valid & INVERSE_VALID)) {
+        cgm_mat4 inv = e->m;
+        if (!cgm_mat4_invert(&inv)) {
+            return NULL;
+        }
+
+        e->inverse = inv;
+        e->valid |= INVERSE_VALID;
+    }
+
+    return &e->inverse;
+}
+
+const cgm_mat3* cgm_mat4_stack_normal(cgm_mat4_stack* s) {
+    cgm_mat4_stack_entry* e = &s->entries[s->top];
+    if (!(e->valid & NORMAL_VALID)) {
+        /* The inverse transpose of [a0 a1 a2] is
+         * [a1 x a2, a2 x a0, a0 x a1] / det
+         */
+        cgm_vec3 a[3];
+        for (int i = 0; i < 3; i++) {
+            cgm_vec3_set(&a[i], e->m.m[i][0], e->m.m[i][1], e->m.m[i][2]);
+        }
+
+        cgm_vec3 c[3];
+        cgm_vec3_cross(&c[0], &a[1], &a[2]);
+        cgm_vec3_cross(&c[1], &a[2], &a[0]);
+        cgm_vec3_cross(&c[2], &a[0], &a[1]);
+
+        float det = cgm_vec3_dot(&a[0], &c[0]);
+        if (det == 0.0F) {
+            return NULL;
+        }
+
+        for (int i = 0; i < 3; i++) {
+            cgm_vec3_scal(&c[i], 1.0F / det);
+            e->normal.vec[i] = c[i];
+        }
+        e->valid |= NORMAL_VALID;
+    }
+
+    return &e->normal;
+}
+
+void cgm_mat4_stack_load(cgm_mat4_stack* s, const cgm_mat4* m) {
+    modify_top(s)->m = *m;
+}
+
+void cgm_mat4_stack_load_identity(cgm_mat4_stack* s) {
+    cgm_mat4_stack_entry* e = &s->entries[s->top];
+    cgm_mat4_set_identity(&e->m);
+
+    /* The identity is its own inverse and normal matrix */
+    cgm_mat4_set_identity(&e->inverse);
+    cgm_mat3_set_identity(&e->normal);
+    e->valid = INVERSE_VALID | NORMAL_VALID;
+}
+
+void cgm_mat4_stack_mul(cgm_mat4_stack* s, const cgm_mat4* m) {
+    cgm_mat4_stack_entry* e = modify_top(s);
+    cgm_mat4 out;
+    cgm_mat4_mul(&out, &e->m, m);
+    e->m = out;
+}
+
+void cgm_mat4_stack_translate(cgm_mat4_stack* s, float x, float y, float z) {
+    cgm_mat4* m = &modify_top(s)->m;
+    for (int j = 0; j < 4; j++) {
+        m->m[3][j] += x * m->m[0][j] + y * m->m[1][j] + z * m->m[2][j];
+    }
+}
+
+void cgm_mat4_stack_scale(cgm_mat4_stack* s, float x, float y, float z) {
+    cgm_mat4* m = &modify_top(s)->m;
+    for (int j = 0; j < 4; j++) {
+        m->m[0][j] *= x;
+        m->m[1][j] *= y;
+        m->m[2][j] *= z;
+    }
+}
+
+void cgm_mat4_stack_rotate_x(cgm_mat4_stack* s, float angle) {
+    float sn, cs;
+    cgm_sincos(angle, &sn, &cs);
+    rotate_columns(&modify_top(s)->m, 1, 2, sn, cs);
+}
+
+void cgm_mat4_stack_rotate_y(cgm_mat4_stack* s, float angle) {
+    float sn, cs;
+    cgm_sincos(angle, &sn, &cs);
+    rotate_columns(&modify_top(s)->m, 0, 2, -sn, cs);
+}
+
+void cgm_mat4_stack_rotate_z(cgm_mat4_stack* s, float angle) {
+    float sn, cs;
+    cgm_sincos(angle, &sn, &cs);
+    rotate_columns(&modify_top(s)->m, 0, 1, sn, cs);
+}
+
+void cgm_mat4_stack_rotate(cgm_mat4_stack* s, const cgm_vec3* axis,
+        float angle) {
+    float mag = cgm_vec3_mag(axis);
+    if (mag == 0) {
+        return;
+    }
+
+    float x = axis->x / mag;
+    float y = axis->y / mag;
+    float z = axis->z / mag;
+
+    float sn, cs;
+    cgm_sincos(angle, &sn, &cs);
+    float p = 1 - cs;
+
+    /* Same rotation as cgm_set_rotate(), r[i][k] is element [i][k] */
+    float r[3][3] = {
+        {cs + x*x * p, x*y * p + z * sn, x*z * p - y * sn},
+        {y*x * p - z * sn, cs + y*y * p, y*z * p + x * sn},
+        {z*x * p + y * sn, z*y * p - x * sn, cs + z*z * p},
+    };
+
+    cgm_mat4* m = &modify_top(s)->m;
+    for (int j = 0; j < 4; j++) {
+        float m0 = m->m[0][j], m1 = m->m[1][j], m2 = m->m[2][j];
+        for (int i = 0; i < 3; i++) {
+            m->m[i][j] = r[i][0] * m0 + r[i][1] * m1 + r[i][2] * m2;
+        }
+    }
+}
+
+/* vim: set ft=c: */
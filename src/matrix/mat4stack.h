@@ -0,0 +1,201 @@
+/**
+ * mat4stack.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * A fixed-capacity stack of cgm_mat4's, as in fixed-function OpenGL.
+ */
+
+#ifndef MAT4STACK_H_
+#define MAT4STACK_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "mat3.h"
+#include "mat4.h"
+#include "../vector/vec3.h"
+
+/**
+ * One level of a cgm_mat4_stack.
+ * Besides the matrix itself, each level caches its inverse and normal
+ * matrix, which are computed when first requested and invalidated when
+ * the matrix changes. Levels are aligned to cache lines.
+ */
+typedef struct cgm_mat4_stack_entry {
+    /**
+     * The matrix.
+     */
+    _Alignas(64) cgm_mat4 m;
+
+    /**
+     * Cached inverse of m.
+     */
+    cgm_mat4 inverse;
+
+    /**
+     * Cached normal matrix of m.
+     */
+    cgm_mat3 normal;
+
+    /**
+     * Which caches are valid (internal flags).
+     */
+    unsigned valid;
+} cgm_mat4_stack_entry;
+
+/**
+ * A stack of matrices.
+ * All operations apply to the top level. As with the functions of
+ * transform.h, transformations are multiplied on the right: after
+ * cgm_mat4_stack_translate(), the top is `top * T'.
+ */
+typedef struct cgm_mat4_stack {
+    /**
+     * Array of capacity levels, allocated with cache-line alignment.
+     */
+    cgm_mat4_stack_entry* entries;
+
+    /**
+     * Maximum number of levels.
+     */
+    size_t capacity;
+
+    /**
+     * Index of the top level.
+     */
+    size_t top;
+} cgm_mat4_stack;
+
+/**
+ * Initializes a matrix stack with one level holding the identity matrix.
+ * @param s - Stack to initialize.
+ * @param capacity - Maximum number of levels (at least 1).
+ * @return false if the levels could not be allocated.
+ */
+bool cgm_mat4_stack_init(cgm_mat4_stack* s, size_t capacity);
+
+/**
+ * Frees the levels of a matrix stack.
+ * @param s - Stack to free.
+ */
+void cgm_mat4_stack_free(cgm_mat4_stack* s);
+
+/**
+ * Pushes a copy of the top level (including its valid caches).
+ * @param s - Stack to push onto.
+ * @return false, without changing the stack, if it is full.
+ */
+bool cgm_mat4_stack_push(cgm_mat4_stack* s);
+
+/**
+ * Pops the top level.
+ * @param s - Stack to pop from.
+ * @return false, without changing the stack, if only one level is left.
+ */
+bool cgm_mat4_stack_pop(cgm_mat4_stack* s);
+
+/**
+ * Gets the top matrix of a stack.
+ * @param s - The stack.
+ * @return The top matrix, valid until the stack is next changed.
+ */
+const cgm_mat4* cgm_mat4_stack_top(const cgm_mat4_stack* s);
+
+/**
+ * Gets the inverse of the top matrix of a stack, computing it if it is
+ * not cached.
+ * @param s - The stack.
+ * @return The inverse, valid until the stack is next changed, or NULL if
+ *         the top matrix is singular.
+ */
+const cgm_mat4* cgm_mat4_stack_inverse(cgm_mat4_stack* s);
+
+/**
+ * Gets the normal matrix (the inverse transpose of the upper-left 3x3
+ * block) of the top matrix of a stack, computing it if it is not cached.
+ * @param s - The stack.
+ * @return The normal matrix, valid until the stack is next changed, or
+ *         NULL if the upper-left block is singular.
+ */
+const cgm_mat3* cgm_mat4_stack_normal(cgm_mat4_stack* s);
+
+/**
+ * Replaces the top matrix of a stack.
+ * @param s - The stack.
+ * @param m - Matrix to load.
+ */
+void cgm_mat4_stack_load(cgm_mat4_stack* s, const cgm_mat4* m);
+
+/**
+ * Replaces the top matrix of a stack with the identity matrix.
+ * @param s - The stack.
+ */
+void cgm_mat4_stack_load_identity(cgm_mat4_stack* s);
+
+/**
+ * Multiplies the top matrix of a stack by a matrix on the right.
+ * @param s - The stack.
+ * @param m - Matrix to multiply by.
+ */
+void cgm_mat4_stack_mul(cgm_mat4_stack* s, const cgm_mat4* m);
+
+/**
+ * Translates the top matrix of a stack, as by cgm_translate().
+ * Only the last column is updated.
+ * @param s - The stack.
+ * @param x - Amount to translate in the x direction.
+ * @param y - Amount to translate in the y direction.
+ * @param z - Amount to translate in the z direction.
+ */
+void cgm_mat4_stack_translate(cgm_mat4_stack* s, float x, float y, float z);
+
+/**
+ * Scales the top matrix of a stack, as by cgm_scale().
+ * Only the first three columns are scaled.
+ * @param s - The stack.
+ * @param x - Amount to scale in the x direction.
+ * @param y - Amount to scale in the y direction.
+ * @param z - Amount to scale in the z direction.
+ */
+void cgm_mat4_stack_scale(cgm_mat4_stack* s, float x, float y, float z);
+
+/**
+ * Rotates the top matrix of a stack around the x axis, as by
+ * cgm_rotate_x().
+ * Only the two affected columns are updated.
+ * @param s - The stack.
+ * @param angle - Angle to rotate in radians.
+ */
+void cgm_mat4_stack_rotate_x(cgm_mat4_stack* s, float angle);
+
+/**
+ * Rotates the top matrix of a stack around the y axis, as by
+ * cgm_rotate_y().
+ * @param s - The stack.
+ * @param angle - Angle to rotate in radians.
+ */
+void cgm_mat4_stack_rotate_y(cgm_mat4_stack* s, float angle);
+
+/**
+ * Rotates the top matrix of a stack around the z axis, as by
+ * cgm_rotate_z().
+ * @param s - The stack.
+ * @param angle - Angle to rotate in radians.
+ */
+void cgm_mat4_stack_rotate_z(cgm_mat4_stack* s, float angle);
+
+/**
+ * Rotates the top matrix of a stack around an axis, as by cgm_rotate().
+ * Only the first three columns are updated.
+ * @param s - The stack.
+ * @param axis - Axis to rotate around.
+ * @param angle - Angle to rotate (counter-clockwise) in radians.
+ */
+void cgm_mat4_stack_rotate(cgm_mat4_stack* s, const cgm_vec3* axis,
+        float angle);
+
+#endif /* MAT4STACK_H_ */
+
+/* vim: set ft=c: */
@@ -0,0 +1,80 @@
+/**
+ * shepperd.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Internal rotation matrix to quaternion kernel shared by the matrix
+ * types. This header is not installed.
+ */
+
+#ifndef SHEPPERD_H_
+#define SHEPPERD_H_
+
+#include <math.h>
+#include <stdbool.h>
+
+/**
+ * Defines the static function NAME to convert the rotation matrix with
+ * columns (m00, m01, m02), (m10, m11, m12), and (m20, m21, m22) to a unit
+ * QUAT with w >= 0, in SCALAR precision with SQRT its square root.
+ * Shepperd's method: 4 w^2, 4 x^2, 4 y^2, and 4 z^2 are each found from
+ * the diagonal, and the largest of them (whose square root is
+ * well-conditioned) gives the other components from the off-diagonal
+ * sums and differences. The case is chosen with selects rather than
+ * branches, so loops calling this vectorize with blends.
+ * Each source file instantiates the precision it needs.
+ */
+#define CGM_SHEPPERD(NAME, SCALAR, QUAT, SQRT) \
+static inline QUAT NAME( \
+        SCALAR m00, SCALAR m01, SCALAR m02, \
+        SCALAR m10, SCALAR m11, SCALAR m12, \
+        SCALAR m20, SCALAR m21, SCALAR m22) { \
+    SCALAR tw = (SCALAR) 1 + m00 + m11 + m22; \
+    SCALAR tx = (SCALAR) 1 + m00 - m11 - m22; \
+    SCALAR ty = (SCALAR) 1 - m00 + m11 - m22; \
+    SCALAR tz = (SCALAR) 1 - m00 - m11 + m22; \
+    \
+    SCALAR d_yz = m12 - m21, s_yz = m12 + m21; \
+    SCALAR d_zx = m20 - m02, s_zx = m20 + m02; \
+    SCALAR d_xy = m01 - m10, s_xy = m01 + m10; \
+    \
+    /* Each case gives 4 |c| q for its largest component c */ \
+    SCALAR t = tw, w = tw, x = d_yz, y = d_zx, z = d_xy; \
+    \
+    bool use_x = tx > t; \
+    t = use_x ? tx : t; \
+    w = use_x ? d_yz : w; \
+    x = use_x ? tx : x; \
+    y = use_x ? s_xy : y; \
+    z = use_x ? s_zx : z; \
+    \
+    bool use_y = ty > t; \
+    t = use_y ? ty : t; \
+    w = use_y ? d_zx : w; \
+    x = use_y ? s_xy : x; \
+    y = use_y ? ty : y; \
+    z = use_y ? s_yz : z; \
+    \
+    bool use_z = tz > t; \
+    t = use_z ? tz : t; \
+    w = use_z ? d_xy : w; \
+    x = use_z ? s_zx : x; \
+    y = use_z ? s_yz : y; \
+    z = use_z ? tz : z; \
+    \
+    /* 4 |c| = 2 sqrt(t); flip the sign as well if w would be negative */ \
+    SCALAR r = (SCALAR) 0.5 / SQRT(t); \
+    r = w < 0 ? -r : r; \
+    \
+    QUAT q; \
+    q.w = w * r; \
+    q.x = x * r; \
+    q.y = y * r; \
+    q.z = z * r; \
+    return q; \
+}
+
+#endif /* SHEPPERD_H_ */
+
+/* vim: set ft=c: */
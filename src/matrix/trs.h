@@ -0,0 +1,48 @@
+/**
+ * trs.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Internal translation-rotation-scale kernel shared by the cgm_mat4 and
+ * cgm_affine builders. This header is not installed.
+ */
+
+#ifndef TRS_H_
+#define TRS_H_
+
+/**
+ * Computes R * S, with R the rotation of the unit quaternion (w, x, y, z)
+ * and S the scale (sx, sy, sz), as columns: rs[c][r] is row r of column
+ * c. Each column of R is scaled as it is written. Callers copy it into
+ * their own layout beside the translation.
+ */
+static inline void cgm_trs_rotation(float rs[3][3],
+        float w, float x, float y, float z,
+        float sx, float sy, float sz) {
+    float xx = x * x;
+    float yy = y * y;
+    float zz = z * z;
+    float xz = x * z;
+    float xy = x * y;
+    float yz = y * z;
+    float wx = w * x;
+    float wy = w * y;
+    float wz = w * z;
+
+    rs[0][0] = sx * (1.0F - 2.0F * (yy +  zz));
+    rs[0][1] = sx * (2.0F * (xy + wz));
+    rs[0][2] = sx * (2.0F * (xz - wy));
+
+    rs[1][0] = sy * (2.0F * (xy - wz));
+    rs[1][1] = sy * (1.0F - 2.0F * (xx +  zz));
+    rs[1][2] = sy * (2.0F * (yz + wx));
+
+    rs[2][0] = sz * (2.0F * (xz + wy));
+    rs[2][1] = sz * (2.0F * (yz - wx));
+    rs[2][2] = sz * (1.0F - 2.0F * (xx +  yy));
+}
+
+#endif /* TRS_H_ */
+
+/* vim: set ft=c: */
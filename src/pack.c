@@ -0,0 +1,474 @@
+/**
+ * pack.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vector/vec3.h"
+#include "vector/vec4.h"
+#include "quaternion/quaternion.h"
+#include "pack.h"
+
+/**
+ * Scalar kernels shared by the single and batch versions. They are
+ * written so that the batch loops vectorize: clamping is done with
+ * selects, which become min and max instructions (fminf() and fmaxf()
+ * do not, as they must return the other operand for NaN), rounding by
+ * adding 0.5 before truncating, and conversions go through int32_t,
+ * which unlike uint32_t converts in one instruction.
+ */
+static inline float clamp(float x, float lo, float hi) {
+    x = x > lo ? x : lo;
+    return x < hi ? x : hi;
+}
+
+static inline uint32_t unorm(float x, float scale) {
+    return (uint32_t) (int32_t) (clamp(x, 0.0F, 1.0F) * scale + 0.5F);
+}
+
+static inline int32_t snorm(float x, float scale) {
+    x = clamp(x, -1.0F, 1.0F) * scale;
+    return (int32_t) (x + copysignf(0.5F, x));
+}
+
+static inline float from_snorm(int32_t i, float scale) {
+    /* -32768 and -32767 both map to -1 */
+    float x = (float) i / scale;
+    return x > -1.0F ? x : -1.0F;
+}
+
+static inline uint32_t pack_oct16(float x, float y, float z) {
+    float l1 = fabsf(x) + fabsf(y) + fabsf(z);
+    l1 = l1 > 0.0F ? l1 : 1.0F;
+    float u = x / l1;
+    float v = y / l1;
+
+    /* Fold the lower half over the diagonals */
+    float fu = (1.0F - fabsf(v)) * copysignf(1.0F, u);
+    float fv = (1.0F - fabsf(u)) * copysignf(1.0F, v);
+    u = z < 0.0F ? fu : u;
+    v = z < 0.0F ? fv : v;
+
+    return (uint32_t) (uint16_t) snorm(u, 32767.0F)
+        | (uint32_t) (uint16_t) snorm(v, 32767.0F) << 16;
+}
+
+static inline void unpack_oct16(uint32_t p, float* x, float* y, float* z) {
+    float u = from_snorm((int16_t) (p & 0xffffU), 32767.0F);
+    float v = from_snorm((int16_t) (p >> 16), 32767.0F);
+
+    /* Unfold: points with z < 0 are moved back by t towards the axes */
+    float w = 1.0F - fabsf(u) - fabsf(v);
+    float t = w < 0.0F ? -w : 0.0F;
+    u -= copysignf(t, u);
+    v -= copysignf(t, v);
+
+    float inv_mag = 1.0F / sqrtf(u * u + v * v + w * w);
+    *x = u * inv_mag;
+    *y = v * inv_mag;
+    *z = w * inv_mag;
+}
+
+static inline uint32_t pack_rgb10a2(const cgm_vec4* c) {
+    return unorm(c->r, 1023.0F)
+        | unorm(c->g, 1023.0F) << 10
+        | unorm(c->b, 1023.0F) << 20
+        | unorm(c->a, 3.0F) << 30;
+}
+
+static inline void unpack_rgb10a2(cgm_vec4* c, uint32_t p) {
+    c->r = (float) (p & 0x3ffU) / 1023.0F;
+    c->g = (float) (p >> 10 & 0x3ffU) / 1023.0F;
+    c->b = (float) (p >> 20 & 0x3ffU) / 1023.0F;
+    c->a = (float) (p >> 30) / 3.0F;
+}
+
+static inline uint32_t pack_rgba8(const cgm_vec4* c) {
+    return unorm(c->r, 255.0F)
+        | unorm(c->g, 255.0F) << 8
+        | unorm(c->b, 255.0F) << 16
+        | unorm(c->a, 255.0F) << 24;
+}
+
+static inline void unpack_rgba8(cgm_vec4* c, uint32_t p) {
+    c->r = (float) (p & 0xffU) / 255.0F;
+    c->g = (float) (p >> 8 & 0xffU) / 255.0F;
+    c->b = (float) (p >> 16 & 0xffU) / 255.0F;
+    c->a = (float) (p >> 24) / 255.0F;
+}
+
+static inline void pack_snorm16(int16_t* p, const cgm_vec4* v) {
+    for (int j = 0; j < 4; j++) {
+        p[j] = (int16_t) snorm(v->v[j], 32767.0F);
+    }
+}
+
+static inline void unpack_snorm16(cgm_vec4* v, const int16_t* p) {
+    for (int j = 0; j < 4; j++) {
+        v->v[j] = from_snorm(p[j], 32767.0F);
+    }
+}
+
+/**
+ * The three smallest components of a quaternion, quantized, and the index
+ * of the largest.
+ */
+struct smallest3 {
+    uint32_t index;
+    uint32_t a, b, c;
+};
+
+/**
+ * Maps [-1/sqrt(2), 1/sqrt(2)] to [0, max] and back.
+ */
+static inline uint32_t quantize(float x, float max) {
+    float u = clamp(x * (float) M_SQRT1_2 + 0.5F, 0.0F, 1.0F);
+    return (uint32_t) (int32_t) (u * max + 0.5F);
+}
+
+static inline float dequantize(uint32_t q, float max) {
+    return (float) (int32_t) q * ((float) M_SQRT2 / max)
+        - (float) M_SQRT1_2;
+}
+
+static inline struct smallest3 pack_smallest3(const cgm_quat* q,
+        float max) {
+    float x = q->x, y = q->y, z = q->z, w = q->w;
+
+    /* Find the largest component by selects rather than branches */
+    uint32_t k = 0;
+    float big = x;
+    k = fabsf(y) > fabsf(big) ? 1 : k;
+    big = k == 1 ? y : big;
+    k = fabsf(z) > fabsf(big) ? 2 : k;
+    big = k == 2 ? z : big;
+    k = fabsf(w) > fabsf(big) ? 3 : k;
+    big = k == 3 ? w : big;
+
+    /* The other three in order, negated if the dropped one is negative */
+    float sign = copysignf(1.0F, big);
+    float a = k == 0 ? y : x;
+    float b = k <= 1 ? z : y;
+    float c = k <= 2 ? w : z;
+
+    struct smallest3 out;
+    out.index = k;
+    out.a = quantize(sign * a, max);
+    out.b = quantize(sign * b, max);
+    out.c = quantize(sign * c, max);
+    return out;
+}
+
+static inline cgm_quat unpack_smallest3(uint32_t k,
+        uint32_t qa, uint32_t qb, uint32_t qc, float max) {
+    float a = dequantize(qa, max);
+    float b = dequantize(qb, max);
+    float c = dequantize(qc, max);
+    float d = 1.0F - a * a - b * b - c * c;
+    d = sqrtf(d > 0.0F ? d : 0.0F);
+
+    cgm_quat q;
+    q.x = k == 0 ? d : a;
+    q.y = k == 0 ? a : k == 1 ? d : b;
+    q.z = k <= 1 ? b : k == 2 ? d : c;
+    q.w = k == 3 ? d : c;
+    return q;
+}
+
+#define QUAT32_MAX 1023.0F
+#define QUAT48_MAX 32767.0F
+#define QUAT64_MAX 1048575.0F
+
+static inline uint32_t pack_quat32(const cgm_quat* q) {
+    struct smallest3 s = pack_smallest3(q, QUAT32_MAX);
+    return s.index << 30 | s.a << 20 | s.b << 10 | s.c;
+}
+
+static inline cgm_quat unpack_quat32(uint32_t p) {
+    return unpack_smallest3(p >> 30, p >> 20 & 0x3ffU, p >> 10 & 0x3ffU,
+            p & 0x3ffU, QUAT32_MAX);
+}
+
+static inline void pack_quat48(uint16_t* p, const cgm_quat* q) {
+    struct smallest3 s = pack_smallest3(q, QUAT48_MAX);
+    p[0] = (uint16_t) (s.a | (s.index & 1U) << 15);
+    p[1] = (uint16_t) (s.b | (s.index >> 1) << 15);
+    p[2] = (uint16_t) s.c;
+}
+
+static inline cgm_quat unpack_quat48(uint32_t p0, uint32_t p1, uint32_t p2) {
+    return unpack_smallest3((p0 >> 15) | (p1 >> 15) << 1,
+            p0 & 0x7fffU, p1 & 0x7fffU, p2 & 0x7fffU, QUAT48_MAX);
+}
+
+/**
+ * The 64-bit form is assembled and taken apart as two 32-bit halves, with
+ * b straddling them, so that the batch loops need no 64-bit shifts and
+ * masks (which the baseline cannot vectorize).
+ */
+static inline uint64_t pack_quat64(const cgm_quat* q) {
+    struct smallest3 s = pack_smallest3(q, QUAT64_MAX);
+    uint32_t hi = s.index << 28 | s.a << 8 | s.b >> 12;
+    uint32_t lo = s.b << 20 | s.c;
+    return (uint64_t) hi << 32 | lo;
+}
+
+static inline cgm_quat unpack_quat64(uint64_t p) {
+    uint32_t hi = (uint32_t) (p >> 32);
+    uint32_t lo = (uint32_t) p;
+    return unpack_smallest3(hi >> 28, hi >> 8 & 0xfffffU,
+            (hi & 0xffU) << 12 | lo >> 20, lo & 0xfffffU, QUAT64_MAX);
+}
+
+uint32_t cgm_pack_oct16(const cgm_vec3* v) {
+    return pack_oct16(v->x, v->y, v->z);
+}
+
+void cgm_unpack_oct16(cgm_vec3* v, uint32_t p) {
+    unpack_oct16(p, &v->x, &v->y, &v->z);
+}
+
+void cgm_pack_oct16_n(uint32_t* p, const cgm_vec3* v, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        p[i] = pack_oct16(v[i].x, v[i].y, v[i].z);
+    }
+}
+
+/**
+ * Number of elements decoded at a time into stack arrays by the batch
+ * unpackers whose outputs or inputs have a stride of 3, which the
+ * baseline (SSE2) cannot interleave in vector registers. The arithmetic
+ * runs vectorized on the arrays, and only the copies to or from the
+ * interleaved layout are scalar.
+ */
+#define UNPACK_BLOCK 256
+
+void cgm_unpack_oct16_n(cgm_vec3* v, const uint32_t* p, size_t n) {
+    float x[UNPACK_BLOCK], y[UNPACK_BLOCK], z[UNPACK_BLOCK];
+    for (size_t i = 0; i < n; i += UNPACK_BLOCK) {
+        size_t k = n - i < UNPACK_BLOCK ? n - i : UNPACK_BLOCK;
+
+        #pragma omp simd
+        for (size_t j = 0; j < k; j++) {
+            unpack_oct16(p[i + j], &x[j], &y[j], &z[j]);
+        }
+
+        for (size_t j = 0; j < k; j++) {
+            v[i + j].x = x[j];
+            v[i + j].y = y[j];
+            v[i + j].z = z[j];
+        }
+    }
+}
+
+uint32_t cgm_pack_rgb10a2(const cgm_vec4* c) {
+    return pack_rgb10a2(c);
+}
+
+void cgm_unpack_rgb10a2(cgm_vec4* c, uint32_t p) {
+    unpack_rgb10a2(c, p);
+}
+
+void cgm_pack_rgb10a2_n(uint32_t* p, const cgm_vec4* c, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        p[i] = pack_rgb10a2(&c[i]);
+    }
+}
+
+void cgm_unpack_rgb10a2_n(cgm_vec4* c, const uint32_t* p, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        unpack_rgb10a2(&c[i], p[i]);
+    }
+}
+
+uint32_t cgm_pack_rgba8(const cgm_vec4* c) {
+    return pack_rgba8(c);
+}
+
+void cgm_unpack_rgba8(cgm_vec4* c, uint32_t p) {
+    unpack_rgba8(c, p);
+}
+
+void cgm_pack_rgba8_n(uint32_t* p, const cgm_vec4* c, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        p[i] = pack_rgba8(&c[i]);
+    }
+}
+
+void cgm_unpack_rgba8_n(cgm_vec4* c, const uint32_t* p, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        unpack_rgba8(&c[i], p[i]);
+    }
+}
+
+void cgm_pack_snorm16(int16_t* p, const cgm_vec4* v) {
+    pack_snorm16(p, v);
+}
+
+void cgm_unpack_snorm16(cgm_vec4* v, const int16_t* p) {
+    unpack_snorm16(v, p);
+}
+
+void cgm_pack_snorm16_n(int16_t* p, const cgm_vec4* v, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        pack_snorm16(&p[4 * i], &v[i]);
+    }
+}
+
+void cgm_unpack_snorm16_n(cgm_vec4* v, const int16_t* p, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        unpack_snorm16(&v[i], &p[4 * i]);
+    }
+}
+
+uint32_t cgm_pack_quat32(const cgm_quat* q) {
+    return pack_quat32(q);
+}
+
+void cgm_unpack_quat32(cgm_quat* q, uint32_t p) {
+    *q = unpack_quat32(p);
+}
+
+void cgm_pack_quat32_n(uint32_t* p, const cgm_quat* q, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        p[i] = pack_quat32(&q[i]);
+    }
+}
+
+void cgm_unpack_quat32_n(cgm_quat* q, const uint32_t* p, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        q[i] = unpack_quat32(p[i]);
+    }
+}
+
+void cgm_unpack_quat32_soa(cgm_quat_soa* q, const uint32_t* p, size_t n) {
+    float* qw = q->w;
+    float* qx = q->x;
+    float* qy = q->y;
+    float* qz = q->z;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_quat r = unpack_quat32(p[i]);
+        qw[i] = r.w;
+        qx[i] = r.x;
+        qy[i] = r.y;
+        qz[i] = r.z;
+    }
+}
+
+void cgm_pack_quat48(uint16_t* p, const cgm_quat* q) {
+    pack_quat48(p, q);
+}
+
+void cgm_unpack_quat48(cgm_quat* q, const uint16_t* p) {
+    *q = unpack_quat48(p[0], p[1], p[2]);
+}
+
+void cgm_pack_quat48_n(uint16_t* p, const cgm_quat* q, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        pack_quat48(&p[3 * i], &q[i]);
+    }
+}
+
+/**
+ * Splits k 48-bit quaternions into their three 16-bit values.
+ */
+static void load_quat48_block(uint32_t* p0, uint32_t* p1, uint32_t* p2,
+        const uint16_t* p, size_t k) {
+    for (size_t j = 0; j < k; j++) {
+        p0[j] = p[3 * j];
+        p1[j] = p[3 * j + 1];
+        p2[j] = p[3 * j + 2];
+    }
+}
+
+void cgm_unpack_quat48_n(cgm_quat* q, const uint16_t* p, size_t n) {
+    uint32_t p0[UNPACK_BLOCK], p1[UNPACK_BLOCK], p2[UNPACK_BLOCK];
+    for (size_t i = 0; i < n; i += UNPACK_BLOCK) {
+        size_t k = n - i < UNPACK_BLOCK ? n - i : UNPACK_BLOCK;
+        load_quat48_block(p0, p1, p2, &p[3 * i], k);
+
+        #pragma omp simd
+        for (size_t j = 0; j < k; j++) {
+            q[i + j] = unpack_quat48(p0[j], p1[j], p2[j]);
+        }
+    }
+}
+
+void cgm_unpack_quat48_soa(cgm_quat_soa* q, const uint16_t* p, size_t n) {
+    float* qw = q->w;
+    float* qx = q->x;
+    float* qy = q->y;
+    float* qz = q->z;
+
+    uint32_t p0[UNPACK_BLOCK], p1[UNPACK_BLOCK], p2[UNPACK_BLOCK];
+    for (size_t i = 0; i < n; i += UNPACK_BLOCK) {
+        size_t k = n - i < UNPACK_BLOCK ? n - i : UNPACK_BLOCK;
+        load_quat48_block(p0, p1, p2, &p[3 * i], k);
+
+        #pragma omp simd
+        for (size_t j = 0; j < k; j++) {
+            cgm_quat r = unpack_quat48(p0[j], p1[j], p2[j]);
+            qw[i + j] = r.w;
+            qx[i + j] = r.x;
+            qy[i + j] = r.y;
+            qz[i + j] = r.z;
+        }
+    }
+}
+
+uint64_t cgm_pack_quat64(const cgm_quat* q) {
+    return pack_quat64(q);
+}
+
+void cgm_unpack_quat64(cgm_quat* q, uint64_t p) {
+    *q = unpack_quat64(p);
+}
+
+void cgm_pack_quat64_n(uint64_t* p, const cgm_quat* q, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        p[i] = pack_quat64(&q[i]);
+    }
+}
+
+void cgm_unpack_quat64_n(cgm_quat* q, const uint64_t* p, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        q[i] = unpack_quat64(p[i]);
+    }
+}
+
+void cgm_unpack_quat64_soa(cgm_quat_soa* q, const uint64_t* p, size_t n) {
+    float* qw = q->w;
+    float* qx = q->x;
+    float* qy = q->y;
+    float* qz = q->z;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_quat r = unpack_quat64(p[i]);
+        qw[i] = r.w;
+        qx[i] = r.x;
+        qy[i] = r.y;
+        qz[i] = r.z;
+    }
+}
+
+/* vim: set ft=c: */
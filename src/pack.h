@@ -0,0 +1,294 @@
+/**
+ * pack.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Packing of vectors and colors into compact normalized integer formats
+ * for vertex streams and textures.
+ *
+ * Components are clamped to the range of the format and rounded to the
+ * nearest step, so decoding an encoded value is within half a step of
+ * the (clamped) original. Packed 32-bit values hold their first component
+ * in the lowest bits, which matches the GPU formats on little-endian
+ * machines.
+ *
+ * Unit quaternions are compressed by the smallest three method: the
+ * component of largest magnitude is dropped (and its sign flipped to
+ * positive, which gives the same rotation), leaving three components in
+ * [-1/sqrt(2), 1/sqrt(2)] which are quantized to b bits each, with 2
+ * bits for the index of the one dropped, which is recovered on decoding
+ * as the square root of 1 minus the sum of their squares. With
+ * h = 1/(sqrt(2) (2^b - 1)) the error in each stored component, the
+ * recovered one is within 3h (it is at least 1/2), so the rotation angle
+ * is within about 7h radians:
+ *      32 bits: b = 10, component error < 2.1e-3, angle < 0.28 degrees.
+ *      48 bits: b = 15, component error < 6.5e-5, angle < 0.009 degrees.
+ *      64 bits: b = 20, component error < 2.1e-6, angle < 0.0003 degrees.
+ * Decoding gives q or -q, whichever has its largest component positive.
+ */
+
+#ifndef PACK_H_
+#define PACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vector/vec3.h"
+#include "vector/vec4.h"
+#include "quaternion/quaternion.h"
+
+/**
+ * Packs a unit vector into 32 bits by octahedral mapping: the vector is
+ * projected onto the octahedron |x| + |y| + |z| = 1, whose lower half is
+ * folded over the upper, and the resulting 2D point is stored as two
+ * snorm16's (x in the low 16 bits). The angular error is below 0.05
+ * degrees. A zero vector is packed as (0, 0, 1).
+ * @param v - Unit vector to pack.
+ * @return The packed vector.
+ */
+uint32_t cgm_pack_oct16(const cgm_vec3* v);
+
+/**
+ * Unpacks a unit vector packed by cgm_pack_oct16().
+ * @param v - Vector to set.
+ * @param p - The packed vector.
+ */
+void cgm_unpack_oct16(cgm_vec3* v, uint32_t p);
+
+/**
+ * Packs an array of unit vectors as by cgm_pack_oct16().
+ * @param p - Array of n packed vectors to set.
+ * @param v - Array of n unit vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_pack_oct16_n(uint32_t* p, const cgm_vec3* v, size_t n);
+
+/**
+ * Unpacks an array of unit vectors packed by cgm_pack_oct16().
+ * @param v - Array of n vectors to set.
+ * @param p - Array of n packed vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_unpack_oct16_n(cgm_vec3* v, const uint32_t* p, size_t n);
+
+/**
+ * Packs a color into the RGB10A2 unorm format: 10 bits each for r, g,
+ * and b (r lowest) and 2 bits for a, each component clamped to [0, 1].
+ * @param c - Color to pack.
+ * @return The packed color.
+ */
+uint32_t cgm_pack_rgb10a2(const cgm_vec4* c);
+
+/**
+ * Unpacks a color packed by cgm_pack_rgb10a2().
+ * @param c - Color to set.
+ * @param p - The packed color.
+ */
+void cgm_unpack_rgb10a2(cgm_vec4* c, uint32_t p);
+
+/**
+ * Packs an array of colors as by cgm_pack_rgb10a2().
+ * @param p - Array of n packed colors to set.
+ * @param c - Array of n colors.
+ * @param n - Number of colors.
+ */
+void cgm_pack_rgb10a2_n(uint32_t* p, const cgm_vec4* c, size_t n);
+
+/**
+ * Unpacks an array of colors packed by cgm_pack_rgb10a2().
+ * @param c - Array of n colors to set.
+ * @param p - Array of n packed colors.
+ * @param n - Number of colors.
+ */
+void cgm_unpack_rgb10a2_n(cgm_vec4* c, const uint32_t* p, size_t n);
+
+/**
+ * Packs a color into the RGBA8 unorm format: 8 bits for each of r, g, b,
+ * and a (r lowest), each component clamped to [0, 1].
+ * @param c - Color to pack.
+ * @return The packed color.
+ */
+uint32_t cgm_pack_rgba8(const cgm_vec4* c);
+
+/**
+ * Unpacks a color packed by cgm_pack_rgba8().
+ * @param c - Color to set.
+ * @param p - The packed color.
+ */
+void cgm_unpack_rgba8(cgm_vec4* c, uint32_t p);
+
+/**
+ * Packs an array of colors as by cgm_pack_rgba8().
+ * @param p - Array of n packed colors to set.
+ * @param c - Array of n colors.
+ * @param n - Number of colors.
+ */
+void cgm_pack_rgba8_n(uint32_t* p, const cgm_vec4* c, size_t n);
+
+/**
+ * Unpacks an array of colors packed by cgm_pack_rgba8().
+ * @param c - Array of n colors to set.
+ * @param p - Array of n packed colors.
+ * @param n - Number of colors.
+ */
+void cgm_unpack_rgba8_n(cgm_vec4* c, const uint32_t* p, size_t n);
+
+/**
+ * Packs a cgm_vec4, such as a tangent with its handedness in w, into 4
+ * snorm16's, each component clamped to [-1, 1].
+ * @param p - Array of 4 packed components to set.
+ * @param v - Vector to pack.
+ */
+void cgm_pack_snorm16(int16_t* p, const cgm_vec4* v);
+
+/**
+ * Unpacks a cgm_vec4 packed by cgm_pack_snorm16().
+ * @param v - Vector to set.
+ * @param p - Array of 4 packed components.
+ */
+void cgm_unpack_snorm16(cgm_vec4* v, const int16_t* p);
+
+/**
+ * Packs an array of cgm_vec4's as by cgm_pack_snorm16().
+ * @param p - Array of 4 n packed components to set.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_pack_snorm16_n(int16_t* p, const cgm_vec4* v, size_t n);
+
+/**
+ * Unpacks an array of cgm_vec4's packed by cgm_pack_snorm16().
+ * @param v - Array of n vectors to set.
+ * @param p - Array of 4 n packed components.
+ * @param n - Number of vectors.
+ */
+void cgm_unpack_snorm16_n(cgm_vec4* v, const int16_t* p, size_t n);
+
+/**
+ * Compresses a unit quaternion into 32 bits: the index of the dropped
+ * component in the top 2 bits, then the other three (in x, y, z, w order)
+ * in 10 bits each, the last lowest.
+ * @param q - Unit quaternion to pack.
+ * @return The packed quaternion.
+ */
+uint32_t cgm_pack_quat32(const cgm_quat* q);
+
+/**
+ * Decompresses a quaternion packed by cgm_pack_quat32().
+ * @param q - Quaternion to set.
+ * @param p - The packed quaternion.
+ */
+void cgm_unpack_quat32(cgm_quat* q, uint32_t p);
+
+/**
+ * Compresses an array of unit quaternions as by cgm_pack_quat32().
+ * @param p - Array of n packed quaternions to set.
+ * @param q - Array of n unit quaternions.
+ * @param n - Number of quaternions.
+ */
+void cgm_pack_quat32_n(uint32_t* p, const cgm_quat* q, size_t n);
+
+/**
+ * Decompresses an array of quaternions packed by cgm_pack_quat32().
+ * @param q - Array of n quaternions to set.
+ * @param p - Array of n packed quaternions.
+ * @param n - Number of quaternions.
+ */
+void cgm_unpack_quat32_n(cgm_quat* q, const uint32_t* p, size_t n);
+
+/**
+ * Decompresses an array of quaternions packed by cgm_pack_quat32() into
+ * a structure of arrays, as used by cgm_quat_soa_nlerp().
+ * @param q - Arrays of n quaternions to set.
+ * @param p - Array of n packed quaternions.
+ * @param n - Number of quaternions.
+ */
+void cgm_unpack_quat32_soa(cgm_quat_soa* q, const uint32_t* p, size_t n);
+
+/**
+ * Compresses a unit quaternion into 48 bits, as 3 16-bit values: the
+ * other three components in 15 bits each, the low and high bits of the
+ * index of the dropped component in the top bits of the first and
+ * second values.
+ * @param p - Array of 3 values to set.
+ * @param q - Unit quaternion to pack.
+ */
+void cgm_pack_quat48(uint16_t* p, const cgm_quat* q);
+
+/**
+ * Decompresses a quaternion packed by cgm_pack_quat48().
+ * @param q - Quaternion to set.
+ * @param p - Array of 3 packed values.
+ */
+void cgm_unpack_quat48(cgm_quat* q, const uint16_t* p);
+
+/**
+ * Compresses an array of unit quaternions as by cgm_pack_quat48().
+ * @param p - Array of 3 n values to set.
+ * @param q - Array of n unit quaternions.
+ * @param n - Number of quaternions.
+ */
+void cgm_pack_quat48_n(uint16_t* p, const cgm_quat* q, size_t n);
+
+/**
+ * Decompresses an array of quaternions packed by cgm_pack_quat48().
+ * @param q - Array of n quaternions to set.
+ * @param p - Array of 3 n packed values.
+ * @param n - Number of quaternions.
+ */
+void cgm_unpack_quat48_n(cgm_quat* q, const uint16_t* p, size_t n);
+
+/**
+ * Decompresses an array of quaternions packed by cgm_pack_quat48() into
+ * a structure of arrays.
+ * @param q - Arrays of n quaternions to set.
+ * @param p - Array of 3 n packed values.
+ * @param n - Number of quaternions.
+ */
+void cgm_unpack_quat48_soa(cgm_quat_soa* q, const uint16_t* p, size_t n);
+
+/**
+ * Compresses a unit quaternion into 64 bits: the index of the dropped
+ * component in bits 60 and 61, then the other three in 20 bits each, the
+ * last lowest.
+ * @param q - Unit quaternion to pack.
+ * @return The packed quaternion.
+ */
+uint64_t cgm_pack_quat64(const cgm_quat* q);
+
+/**
+ * Decompresses a quaternion packed by cgm_pack_quat64().
+ * @param q - Quaternion to set.
+ * @param p - The packed quaternion.
+ */
+void cgm_unpack_quat64(cgm_quat* q, uint64_t p);
+
+/**
+ * Compresses an array of unit quaternions as by cgm_pack_quat64().
+ * @param p - Array of n packed quaternions to set.
+ * @param q - Array of n unit quaternions.
+ * @param n - Number of quaternions.
+ */
+void cgm_pack_quat64_n(uint64_t* p, const cgm_quat* q, size_t n);
+
+/**
+ * Decompresses an array of quaternions packed by cgm_pack_quat64().
+ * @param q - Array of n quaternions to set.
+ * @param p - Array of n packed quaternions.
+ * @param n - Number of quaternions.
+ */
+void cgm_unpack_quat64_n(cgm_quat* q, const uint64_t* p, size_t n);
+
+/**
+ * Decompresses an array of quaternions packed by cgm_pack_quat64() into
+ * a structure of arrays.
+ * @param q - Arrays of n quaternions to set.
+ * @param p - Array of n packed quaternions.
+ * @param n - Number of quaternions.
+ */
+void cgm_unpack_quat64_soa(cgm_quat_soa* q, const uint64_t* p, size_t n);
+
+#endif /* PACK_H_ */
+
+/* vim: set ft=c: */
@@ -0,0 +1,235 @@
+/**
+ * pool.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+/* For pthread_setaffinity_np() */
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "pool.h"
+
+/**
+ * A cgm_parallel_for() call in progress.
+ */
+struct job {
+    void (*fn)(void* ctx, size_t begin, size_t end);
+    void* ctx;
+    size_t n;
+    size_t chunk;
+    size_t chunks;
+};
+
+struct worker {
+    cgm_pool* pool;
+    int index;
+    pthread_t id;
+};
+
+struct cgm_pool {
+    /**
+     * Number of threads including the caller; workers has threads - 1
+     * entries.
+     */
+    int threads;
+    struct worker* workers;
+
+    /**
+     * Held for the whole of a cgm_parallel_for() call.
+     */
+    pthread_mutex_t submit;
+
+    /**
+     * Guards the fields below.
+     */
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned long generation;
+    int pending;
+    bool stop;
+    struct job job;
+};
+
+/**
+ * Pool whose chunk the current thread is running, to run nested calls
+ * serially rather than deadlock.
+ */
+static _Thread_local cgm_pool* current = NULL;
+
+/**
+ * Runs chunks index, index + stride, index + 2 * stride, ... of a job.
+ */
+static void run_share(const struct job* job, size_t index, size_t stride) {
+    for (size_t k = index; k < job->chunks; k += stride) {
+        size_t begin = k * job->chunk;
+        size_t end = job->n - begin > job->chunk ?
+            begin + job->chunk : job->n;
+        job->fn(job->ctx, begin, end);
+    }
+}
+
+static void* run_worker(void* arg) {
+    struct worker* w = arg;
+    cgm_pool* pool = w->pool;
+    unsigned long seen = 0;
+
+    current = pool;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+
+        if (pool->stop) {
+            break;
+        }
+
+        seen = pool->generation;
+        struct job job = pool->job;
+        pthread_mutex_unlock(&pool->lock);
+
+        run_share(&job, w->index, pool->threads);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+static void pin(pthread_t id, int cpu) {
+#ifdef __linux__
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(id, sizeof(set), &set);
+    }
+#else
+    (void) id;
+    (void) cpu;
+#endif
+}
+
+cgm_pool* cgm_pool_create(int threads, const int* cpus) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int) online : 1;
+    }
+
+    cgm_pool* pool = calloc(1, sizeof(cgm_pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->workers = calloc(threads, sizeof(struct worker));
+    if (pool->workers == NULL) {
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->submit, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    /* Workers are numbered from 1, the calling thread being 0. The count
+     * is only raised once a worker has started, so it never waits on one
+     * that does not exist.
+     */
+    pool->threads = 1;
+    for (int k = 1; k < threads; k++) {
+        struct worker* w = &pool->workers[k - 1];
+        w->pool = pool;
+        w->index = k;
+        if (pthread_create(&w->id, NULL, run_worker, w) != 0) {
+            break;
+        }
+
+        if (cpus != NULL) {
+            pin(w->id, cpus[k - 1]);
+        }
+        pool->threads++;
+    }
+
+    return pool;
+}
+
+void cgm_pool_destroy(cgm_pool* pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int k = 1; k < pool->threads; k++) {
+        pthread_join(pool->workers[k - 1].id, NULL);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->submit);
+    free(pool->workers);
+    free(pool);
+}
+
+int cgm_pool_threads(const cgm_pool* pool) {
+    return pool == NULL ? 1 : pool->threads;
+}
+
+void cgm_parallel_for(cgm_pool* pool, size_t n, size_t chunk,
+        void (*fn)(void* ctx, size_t begin, size_t end), void* ctx) {
+    if (chunk == 0) {
+        chunk = CGM_PARALLEL_CHUNK;
+    }
+
+    struct job job = {fn, ctx, n, chunk, (n + chunk - 1) / chunk};
+    if (pool == NULL || pool->threads < 2 || job.chunks < 2
+            || current == pool) {
+        run_share(&job, 0, 1);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->submit);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->pending = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    cgm_pool* outer = current;
+    current = pool;
+    run_share(&job, 0, pool->threads);
+    current = outer;
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->submit);
+}
+
+/* vim: set ft=c: */
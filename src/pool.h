@@ -0,0 +1,86 @@
+/**
+ * pool.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * A pool of worker threads for splitting batch kernels over several
+ * cores.
+ *
+ * Work is given as a range of n elements, cut into fixed chunks. Chunk
+ * boundaries depend only on n and the chunk size, and chunk k always runs
+ * on thread k mod the pool's thread count, so the same call splits the
+ * same way every time.
+ *
+ * Every batch function taking a cgm_pool* accepts NULL to run on the
+ * calling thread alone.
+ */
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <stddef.h>
+
+/**
+ * Default number of elements per chunk for cgm_parallel_for().
+ */
+#define CGM_PARALLEL_CHUNK 4096
+
+/**
+ * A pool of worker threads (opaque).
+ */
+typedef struct cgm_pool cgm_pool;
+
+/**
+ * Creates a pool of worker threads.
+ * The thread calling cgm_parallel_for() also does a share of the work,
+ * so threads - 1 workers are started. If some cannot be started, the
+ * pool uses those that were.
+ * @param threads - Number of threads to run on, including the calling
+ *                  thread, or 0 or less for one per online CPU.
+ * @param cpus - NULL, or an array of threads - 1 CPU numbers: the k-th
+ *               worker (running chunks on thread k, 1 <= k < threads) is
+ *               pinned to CPU cpus[k - 1]. A negative number leaves that
+ *               worker unpinned. Pinning is only supported on Linux and
+ *               is otherwise ignored.
+ * @return The new pool, or NULL if it could not be allocated (which
+ *         batch functions treat as running serially).
+ */
+cgm_pool* cgm_pool_create(int threads, const int* cpus);
+
+/**
+ * Stops the workers of a pool and frees it.
+ * No call to cgm_parallel_for() may be running on the pool.
+ * @param pool - Pool to destroy, or NULL.
+ */
+void cgm_pool_destroy(cgm_pool* pool);
+
+/**
+ * Gets the number of threads a pool runs on, including the calling
+ * thread.
+ * @param pool - The pool, or NULL.
+ * @return The number of threads (1 for NULL).
+ */
+int cgm_pool_threads(const cgm_pool* pool);
+
+/**
+ * Calls fn(ctx, begin, end) for every chunk [begin, end) of [0, n).
+ * Chunk k covers [k * chunk, min((k + 1) * chunk, n)) and runs on thread
+ * k mod cgm_pool_threads(pool), the calling thread being thread 0.
+ * Returns once every chunk has finished.
+ * If pool is NULL, or the call is made from within a chunk of the same
+ * pool, the chunks are run in order on the calling thread. Calls from
+ * several threads on one pool run one at a time.
+ * @param pool - Pool to run on, or NULL.
+ * @param n - Number of elements.
+ * @param chunk - Number of elements per chunk, or 0 for
+ *                CGM_PARALLEL_CHUNK.
+ * @param fn - Function to call for each chunk.
+ * @param ctx - Context passed to fn.
+ */
+void cgm_parallel_for(cgm_pool* pool, size_t n, size_t chunk,
+        void (*fn)(void* ctx, size_t begin, size_t end), void* ctx);
+
+#endif /* POOL_H_ */
+
+/* vim: set ft=c: */
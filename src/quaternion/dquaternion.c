@@ -7,10 +7,110 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "../vector/dvec3.h"
 #include "dquaternion.h"
+#include "soa.h"
+
+/**
+ * Interpolation kernels shared by the single and SoA versions.
+ * Quaternions are passed by value so that the SoA loops can keep them in
+ * registers.
+ */
+static inline cgm_dquat nlerp(cgm_dquat p, cgm_dquat q, double t) {
+    double d = p.w * q.w + p.x * q.x + p.y * q.y + p.z * q.z;
+
+    /* Take the shortest arc */
+    double s = d < 0.0 ? -t : t;
+    double r = 1.0 - t;
+
+    cgm_dquat out;
+    out.w = r * p.w + s * q.w;
+    out.x = r * p.x + s * q.x;
+    out.y = r * p.y + s * q.y;
+    out.z = r * p.z + s * q.z;
+
+    double inv_mag = 1.0 / sqrt(out.w * out.w + out.x * out.x
+            + out.y * out.y + out.z * out.z);
+    out.w *= inv_mag;
+    out.x *= inv_mag;
+    out.y *= inv_mag;
+    out.z *= inv_mag;
+    return out;
+}
+
+static inline cgm_dquat slerp(cgm_dquat p, cgm_dquat q, double t) {
+    double d = p.w * q.w + p.x * q.x + p.y * q.y + p.z * q.z;
+    double sign = 1.0;
+    if (d < 0.0) {
+        d = -d;
+        sign = -1.0;
+    }
+
+    /* sin(theta) is too small to divide by, but the arc is close enough
+     * to a line here
+     */
+    if (d > 0.9995) {
+        return nlerp(p, q, t);
+    }
+
+    double theta = acos(d);
+    double inv_sin = 1.0 / sqrt(1.0 - d * d);
+    double s0 = sin((1.0 - t) * theta) * inv_sin;
+    double s1 = sign * sin(t * theta) * inv_sin;
+
+    cgm_dquat out;
+    out.w = s0 * p.w + s1 * q.w;
+    out.x = s0 * p.x + s1 * q.x;
+    out.y = s0 * p.y + s1 * q.y;
+    out.z = s0 * p.z + s1 * q.z;
+    return out;
+}
+
+/**
+ * Corrects t so that nlerp has nearly constant angular velocity.
+ * The correction is a cubic in t which vanishes at 0, 1/2 and 1, scaled
+ * by a factor fit to |p . q|. See "Approximating slerp" by Arseny
+ * Kapoulkine.
+ */
+static inline cgm_dquat slerp_fast(cgm_dquat p, cgm_dquat q, double t) {
+    double d = fabs(p.w * q.w + p.x * q.x + p.y * q.y + p.z * q.z);
+    double a = 1.0904 + d * (-3.2452 + d * (3.55645 - d * 1.43519));
+    double b = 0.848013 + d * (-1.06021 + d * 0.215638);
+    double k = a * (t - 0.5) * (t - 0.5) + b;
+
+    return nlerp(p, q, t + t * (t - 0.5) * (t - 1.0) * k);
+}
+
+/**
+ * Unlike the float version, this takes a full 1 / sqrt: one Newton step
+ * from 1 leaves an error of about 0.2 (s - 1)^4, well above double
+ * rounding. A zero quaternion is left unchanged.
+ */
+static inline cgm_dquat renormalize(cgm_dquat q) {
+    double s = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
+    double r = s > 0.0 ? 1.0 / sqrt(s) : 1.0;
+    q.w *= r;
+    q.x *= r;
+    q.y *= r;
+    q.z *= r;
+    return q;
+}
+
+/**
+ * q + h (0, (x, y, z)) q, renormalized.
+ */
+static inline cgm_dquat integrate(cgm_dquat q,
+        double x, double y, double z, double h) {
+    cgm_dquat out;
+    out.w = q.w - h * (x * q.x + y * q.y + z * q.z);
+    out.x = q.x + h * (x * q.w + y * q.z - z * q.y);
+    out.y = q.y + h * (y * q.w + z * q.x - x * q.z);
+    out.z = q.z + h * (z * q.w + x * q.y - y * q.x);
+    return renormalize(out);
+}
 
 void cgm_dquat_set(cgm_dquat* q,
         double w, double x, double y, double z) {
@@ -101,6 +201,52 @@ void cgm_dquat_scale(cgm_dquat* q, double val) {
     q->z *= val;
 }
 
+void cgm_dquat_normalize(cgm_dquat* q) {
+    double mag = cgm_dquat_mag(q);
+    if (mag != 0) {
+        cgm_dquat_scale(q, 1 / mag);
+    }
+}
+
+void cgm_dquat_soa_renormalize(cgm_dquat_soa* q, size_t n) {
+    double* qw = q->w;
+    double* qx = q->x;
+    double* qy = q->y;
+    double* qz = q->z;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_dquat a = {{qw[i], {{qx[i], qy[i], qz[i]}}}};
+        cgm_dquat r = renormalize(a);
+        qw[i] = r.w;
+        qx[i] = r.x;
+        qy[i] = r.y;
+        qz[i] = r.z;
+    }
+}
+
+void cgm_dquat_soa_integrate(cgm_dquat_soa* q,
+        const cgm_dvec3_soa* omega, double dt, size_t n) {
+    double* qw = q->w;
+    double* qx = q->x;
+    double* qy = q->y;
+    double* qz = q->z;
+    const double* x = omega->x;
+    const double* y = omega->y;
+    const double* z = omega->z;
+    double h = 0.5 * dt;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_dquat a = {{qw[i], {{qx[i], qy[i], qz[i]}}}};
+        cgm_dquat r = integrate(a, x[i], y[i], z[i], h);
+        qw[i] = r.w;
+        qx[i] = r.x;
+        qy[i] = r.y;
+        qz[i] = r.z;
+    }
+}
+
 void cgm_dquat_mul(cgm_dquat* out,
         const cgm_dquat* p,
         const cgm_dquat* q) {
@@ -130,4 +276,49 @@ void cgm_dquat_rotate(cgm_dquat* q,
     cgm_dquat_mul_l(q, &tmp);
 }
 
+void cgm_dquat_slerp(cgm_dquat* out,
+        const cgm_dquat* p,
+        const cgm_dquat* q,
+        double t) {
+    *out = slerp(*p, *q, t);
+}
+
+void cgm_dquat_nlerp(cgm_dquat* out,
+        const cgm_dquat* p,
+        const cgm_dquat* q,
+        double t) {
+    *out = nlerp(*p, *q, t);
+}
+
+void cgm_dquat_slerp_fast(cgm_dquat* out,
+        const cgm_dquat* p,
+        const cgm_dquat* q,
+        double t) {
+    *out = slerp_fast(*p, *q, t);
+}
+
+void cgm_dquat_soa_slerp(cgm_dquat_soa* out,
+        const cgm_dquat_soa* p,
+        const cgm_dquat_soa* q,
+        const double* t,
+        size_t n) {
+    SOA_INTERPOLATE(cgm_dquat, slerp, out, p, q, t, n);
+}
+
+void cgm_dquat_soa_nlerp(cgm_dquat_soa* out,
+        const cgm_dquat_soa* p,
+        const cgm_dquat_soa* q,
+        const double* t,
+        size_t n) {
+    SOA_INTERPOLATE(cgm_dquat, nlerp, out, p, q, t, n);
+}
+
+void cgm_dquat_soa_slerp_fast(cgm_dquat_soa* out,
+        const cgm_dquat_soa* p,
+        const cgm_dquat_soa* q,
+        const double* t,
+        size_t n) {
+    SOA_INTERPOLATE(cgm_dquat, slerp_fast, out, p, q, t, n);
+}
+
 /* vim: set ft=c: */
@@ -9,6 +9,7 @@
 #define DQUATERNION_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "../vector/dvec3.h"
 
@@ -50,6 +51,18 @@ typedef union cgm_dquat {
 
 #define CGM_QUAT(W, X, Y, Z) ((const cgm_dquat*) &((cgm_dquat) {{(W), (X), (Y), (Z)}}))
 
+/**
+ * Structure-of-arrays view of a sequence of cgm_dquat's.
+ * Each pointer refers to an array of the same length holding one
+ * component of every quaternion. The arrays must not overlap.
+ */
+typedef struct cgm_dquat_soa {
+    double* w;
+    double* x;
+    double* y;
+    double* z;
+} cgm_dquat_soa;
+
 /**
  * Sets the components of a quaternion.
  * @param q - The quaternion to set.
@@ -142,6 +155,41 @@ double cgm_dquat_mag(const cgm_dquat* q);
  */
 void cgm_dquat_scale(cgm_dquat* q, double val);
 
+/**
+ * Normalizes a quaternion to unit magnitude.
+ * A quaternion of magnitude 0 is left unchanged.
+ * @param q - The quaternion to normalize.
+ */
+void cgm_dquat_normalize(cgm_dquat* q);
+
+/**
+ * Renormalizes quaternions stored as structures of arrays which have
+ * drifted slightly from unit magnitude, such as after integration or
+ * repeated multiplication.
+ * Each quaternion is divided by its magnitude, so (unlike
+ * cgm_quat_soa_renormalize()) the result is exact to rounding however far
+ * it has drifted. Quaternions of magnitude 0 are left unchanged.
+ * @param q - Arrays of n quaternions to renormalize.
+ * @param n - Number of quaternions.
+ */
+void cgm_dquat_soa_renormalize(cgm_dquat_soa* q, size_t n);
+
+/**
+ * Advances unit quaternions stored as structures of arrays by angular
+ * velocities over a time step.
+ * Each q[i] is set to q[i] + dt / 2 (0, omega[i]) q[i] and renormalized
+ * as by cgm_dquat_soa_renormalize(). This rotates by
+ * 2 atan(|omega[i]| dt / 2) rather than |omega[i]| dt, which is within
+ * 1% while |omega[i]| dt stays below about 0.35 radians.
+ * @param q - Arrays of n orientations to advance.
+ * @param omega - Arrays of n angular velocities, in radians per unit of
+ *                time, in the same (world) frame that q rotates into.
+ * @param dt - Time step.
+ * @param n - Number of quaternions.
+ */
+void cgm_dquat_soa_integrate(cgm_dquat_soa* q,
+        const cgm_dvec3_soa* omega, double dt, size_t n);
+
 /**
  * Multiplies two quaternions.
  * The operation `out = p * q' is performed.
@@ -179,6 +227,108 @@ void cgm_dquat_rotate(cgm_dquat* q,
         const cgm_dvec3* axis,
         double angle);
 
+/**
+ * Spherically interpolates between two unit quaternions.
+ * The interpolation follows the shortest arc: if p and q are more than
+ * half a turn apart, -q is used instead of q. Nearly identical
+ * quaternions fall back to cgm_dquat_nlerp().
+ * out may be the same as p or q.
+ * @param out - The quaternion to store the result.
+ * @param p - The quaternion at t = 0.
+ * @param q - The quaternion at t = 1.
+ * @param t - Interpolation parameter in [0, 1].
+ */
+void cgm_dquat_slerp(cgm_dquat* out,
+        const cgm_dquat* p,
+        const cgm_dquat* q,
+        double t);
+
+/**
+ * Linearly interpolates between two unit quaternions and normalizes the
+ * result.
+ * This follows the same path as cgm_dquat_slerp() (including the
+ * shortest arc handling) but not at constant angular velocity.
+ * out may be the same as p or q.
+ * @param out - The quaternion to store the result.
+ * @param p - The quaternion at t = 0.
+ * @param q - The quaternion at t = 1.
+ * @param t - Interpolation parameter in [0, 1].
+ */
+void cgm_dquat_nlerp(cgm_dquat* out,
+        const cgm_dquat* p,
+        const cgm_dquat* q,
+        double t);
+
+/**
+ * Approximates cgm_dquat_slerp() without any trigonometric functions.
+ * The interpolation parameter is corrected by a polynomial in t and
+ * |p . q| before a cgm_dquat_nlerp(), which brings the angular velocity
+ * close to constant. The correction is only fit to a few digits, so
+ * each component of the result is within 4e-4 of cgm_dquat_slerp().
+ * out may be the same as p or q.
+ * @param out - The quaternion to store the result.
+ * @param p - The quaternion at t = 0.
+ * @param q - The quaternion at t = 1.
+ * @param t - Interpolation parameter in [0, 1].
+ */
+void cgm_dquat_slerp_fast(cgm_dquat* out,
+        const cgm_dquat* p,
+        const cgm_dquat* q,
+        double t);
+
+/**
+ * Spherically interpolates between pairs of quaternions stored as
+ * structures of arrays.
+ * out[i] is set to cgm_dquat_slerp(p[i], q[i], t[i]).
+ * out may be the same as p or q.
+ * @param out - Arrays of n quaternions to store the results.
+ * @param p - Arrays of n quaternions at t = 0.
+ * @param q - Arrays of n quaternions at t = 1.
+ * @param t - Array of n interpolation parameters.
+ * @param n - Number of quaternions.
+ */
+void cgm_dquat_soa_slerp(cgm_dquat_soa* out,
+        const cgm_dquat_soa* p,
+        const cgm_dquat_soa* q,
+        const double* t,
+        size_t n);
+
+/**
+ * Normalized linear interpolation of quaternions stored as structures of
+ * arrays.
+ * out[i] is set to cgm_dquat_nlerp(p[i], q[i], t[i]).
+ * out may be the same as p or q.
+ * @param out - Arrays of n quaternions to store the results.
+ * @param p - Arrays of n quaternions at t = 0.
+ * @param q - Arrays of n quaternions at t = 1.
+ * @param t - Array of n interpolation parameters.
+ * @param n - Number of quaternions.
+ */
+void cgm_dquat_soa_nlerp(cgm_dquat_soa* out,
+        const cgm_dquat_soa* p,
+        const cgm_dquat_soa* q,
+        const double* t,
+        size_t n);
+
+/**
+ * Approximate spherical interpolation of quaternions stored as
+ * structures of arrays.
+ * out[i] is set to cgm_dquat_slerp_fast(p[i], q[i], t[i]). Unlike
+ * cgm_dquat_soa_slerp(), this needs no calls into libm and so vectorizes
+ * fully.
+ * out may be the same as p or q.
+ * @param out - Arrays of n quaternions to store the results.
+ * @param p - Arrays of n quaternions at t = 0.
+ * @param q - Arrays of n quaternions at t = 1.
+ * @param t - Array of n interpolation parameters.
+ * @param n - Number of quaternions.
+ */
+void cgm_dquat_soa_slerp_fast(cgm_dquat_soa* out,
+        const cgm_dquat_soa* p,
+        const cgm_dquat_soa* q,
+        const double* t,
+        size_t n);
+
 #endif /* DQUATERNION_H_ */
 
 /* vim: set ft=c: */
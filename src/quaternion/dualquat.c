@@ -0,0 +1,105 @@
+/**
+ * dualquat.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "quaternion.h"
+#include "dualquat.h"
+
+void cgm_dualquat_set(cgm_dualquat* dq,
+        const cgm_quat* rot,
+        const cgm_vec3* trans) {
+    cgm_quat t, r = *rot;
+    cgm_quat_set(&t, 0.0F, 0.5F * trans->x, 0.5F * trans->y,
+            0.5F * trans->z);
+
+    dq->real = r;
+    cgm_quat_mul(&dq->dual, &t, &r);
+}
+
+void cgm_dualquat_set_identity(cgm_dualquat* dq) {
+    cgm_quat_set_identity(&dq->real);
+    cgm_quat_set(&dq->dual, 0.0F, 0.0F, 0.0F, 0.0F);
+}
+
+void cgm_dualquat_from_mat4(cgm_dualquat* dq, const cgm_mat4* m) {
+    cgm_quat rot;
+    cgm_quat_from_mat4(&rot, m);
+    cgm_vec3 trans;
+    cgm_vec3_set(&trans, m->m[3][0], m->m[3][1], m->m[3][2]);
+    cgm_dualquat_set(dq, &rot, &trans);
+}
+
+void cgm_dualquat_to_mat4(cgm_mat4* m, const cgm_dualquat* dq) {
+    cgm_vec3 trans;
+    cgm_dualquat_get_translation(&trans, dq);
+
+    cgm_mat4_set_quat(m, &dq->real);
+    m->m[3][0] = trans.x;
+    m->m[3][1] = trans.y;
+    m->m[3][2] = trans.z;
+}
+
+void cgm_dualquat_get_translation(cgm_vec3* trans, const cgm_dualquat* dq) {
+    /* t = 2 dual real* */
+    cgm_quat conj = dq->real, t;
+    cgm_quat_conjugate(&conj);
+    cgm_quat_mul(&t, &dq->dual, &conj);
+
+    cgm_vec3_set(trans, 2.0F * t.x, 2.0F * t.y, 2.0F * t.z);
+}
+
+cgm_dualquat* cgm_dualquat_cpy(cgm_dualquat* dest, const cgm_dualquat* src) {
+    return memmove(dest, src, sizeof(cgm_dualquat));
+}
+
+void cgm_dualquat_mul(cgm_dualquat* out,
+        const cgm_dualquat* p,
+        const cgm_dualquat* q) {
+    cgm_quat real, rd, dr;
+    cgm_quat_mul(&real, &p->real, &q->real);
+    cgm_quat_mul(&rd, &p->real, &q->dual);
+    cgm_quat_mul(&dr, &p->dual, &q->real);
+
+    out->real = real;
+    cgm_quat_set(&out->dual, rd.w + dr.w, rd.x + dr.x, rd.y + dr.y,
+            rd.z + dr.z);
+}
+
+void cgm_dualquat_norm(cgm_dualquat* dq) {
+    float inv = 1.0F / cgm_quat_mag(&dq->real);
+    cgm_quat_scale(&dq->real, inv);
+    cgm_quat_scale(&dq->dual, inv);
+
+    /* Make the dual part orthogonal to the real part */
+    float d = cgm_quat_dot(&dq->real, &dq->dual);
+    dq->dual.w -= d * dq->real.w;
+    dq->dual.x -= d * dq->real.x;
+    dq->dual.y -= d * dq->real.y;
+    dq->dual.z -= d * dq->real.z;
+}
+
+void cgm_dualquat_transform_v3(const cgm_dualquat* dq, cgm_vec3* v) {
+    cgm_vec3 trans;
+    cgm_dualquat_get_translation(&trans, dq);
+    cgm_quat_rotate_v3(&dq->real, v);
+    cgm_vec3_add(v, &trans);
+}
+
+int cgm_dualquat_fprintf(FILE* stream, const cgm_dualquat* dq) {
+    return fprintf(stream, "(%g, %g, %g, %g) + e(%g, %g, %g, %g)\n",
+            dq->real.x, dq->real.y, dq->real.z, dq->real.w,
+            dq->dual.x, dq->dual.y, dq->dual.z, dq->dual.w);
+}
+
+int cgm_dualquat_printf(const cgm_dualquat* dq) {
+    return cgm_dualquat_fprintf(stdout, dq);
+}
+
+/* vim: set ft=c: */
@@ -0,0 +1,131 @@
+/**
+ * dualquat.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Dual quaternions, representing rigid transforms (a rotation followed by
+ * a translation) in 8 floats.
+ */
+
+#ifndef DUALQUAT_H_
+#define DUALQUAT_H_
+
+#include <stdio.h>
+
+#include "quaternion.h"
+#include "../vector/vec3.h"
+#include "../matrix/mat4.h"
+
+/**
+ * A dual quaternion `real + e dual', where e^2 = 0.
+ * A unit dual quaternion represents the rigid transform that rotates by
+ * real and then translates by t, with dual = (1/2) (0, t) real.
+ */
+typedef struct cgm_dualquat {
+    /**
+     * The real part, holding the rotation.
+     */
+    cgm_quat real;
+
+    /**
+     * The dual part, holding the translation.
+     */
+    cgm_quat dual;
+} cgm_dualquat;
+
+/**
+ * Sets a dual quaternion from a rotation and a translation.
+ * The resulting transform rotates by rot and then translates by trans.
+ * @param dq - The dual quaternion to set.
+ * @param rot - Unit quaternion of the rotation.
+ * @param trans - The translation.
+ */
+void cgm_dualquat_set(cgm_dualquat* dq,
+        const cgm_quat* rot,
+        const cgm_vec3* trans);
+
+/**
+ * Sets a dual quaternion to the identity transform.
+ * @param dq - The dual quaternion to set.
+ */
+void cgm_dualquat_set_identity(cgm_dualquat* dq);
+
+/**
+ * Sets a dual quaternion from a rigid cgm_mat4.
+ * The upper-left 3x3 block of m must be a rotation (orthonormal, without
+ * scale or reflection) and the last row must be (0, 0, 0, 1).
+ * @param dq - The dual quaternion to set.
+ * @param m - Rigid matrix from which to set.
+ */
+void cgm_dualquat_from_mat4(cgm_dualquat* dq, const cgm_mat4* m);
+
+/**
+ * Sets a cgm_mat4 to the rigid transform of a unit dual quaternion.
+ * @param m - Matrix to set.
+ * @param dq - Unit dual quaternion from which to set.
+ */
+void cgm_dualquat_to_mat4(cgm_mat4* m, const cgm_dualquat* dq);
+
+/**
+ * Extracts the translation of a unit dual quaternion.
+ * @param trans - Vector to store the translation.
+ * @param dq - Unit dual quaternion to extract from.
+ */
+void cgm_dualquat_get_translation(cgm_vec3* trans, const cgm_dualquat* dq);
+
+/**
+ * Copies a dual quaternion into another.
+ * @param dest - The dual quaternion into which to copy.
+ * @param src - The dual quaternion to copy.
+ * @return The dual quaternion into which data was copied.
+ */
+cgm_dualquat* cgm_dualquat_cpy(cgm_dualquat* dest, const cgm_dualquat* src);
+
+/**
+ * Multiplies two dual quaternions.
+ * The operation `out = p * q' is performed; as with matrices, the result
+ * applies q first and then p. out may be the same as p or q.
+ * @param out - The dual quaternion to store the result.
+ * @param p - The dual quaternion multiplied on the left.
+ * @param q - The dual quaternion multiplied on the right.
+ */
+void cgm_dualquat_mul(cgm_dualquat* out,
+        const cgm_dualquat* p,
+        const cgm_dualquat* q);
+
+/**
+ * Normalizes a dual quaternion.
+ * Both parts are divided by the magnitude of the real part, and the
+ * component of the dual part along the real part is removed so that the
+ * result is a unit dual quaternion (a rigid transform).
+ * @param dq - The dual quaternion to normalize.
+ */
+void cgm_dualquat_norm(cgm_dualquat* dq);
+
+/**
+ * Transforms a point by a unit dual quaternion: it is rotated by the real
+ * part and then translated.
+ * @param dq - Unit dual quaternion to transform by.
+ * @param v - Point to transform.
+ */
+void cgm_dualquat_transform_v3(const cgm_dualquat* dq, cgm_vec3* v);
+
+/**
+ * Writes a dual quaternion to a stream.
+ * @param stream - The stream to which to write.
+ * @param dq - The dual quaternion to write.
+ * @return The number of characters written.
+ */
+int cgm_dualquat_fprintf(FILE* stream, const cgm_dualquat* dq);
+
+/**
+ * Writes a dual quaternion to stdout.
+ * @param dq - The dual quaternion to write.
+ * @return The number of characters written.
+ */
+int cgm_dualquat_printf(const cgm_dualquat* dq);
+
+#endif /* DUALQUAT_H_ */
+
+/* vim: set ft=c: */
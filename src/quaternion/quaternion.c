@@ -7,9 +7,160 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
+#include "../sincos.h"
 #include "quaternion.h"
+#include "rotate.h"
+#include "soa.h"
+
+static inline cgm_quat compose_euler(float sx, float cx, float sy, float cy,
+        float sz, float cz) {
+    cgm_quat q;
+    q.w = cx * cy * cz + sx * sy * sz;
+    q.x = sx * cy * cz - cx * sy * sz;
+    q.y = cx * sy * cz + sx * cy * sz;
+    q.z = cx * cy * sz - sx * sy * cz;
+    return q;
+}
+
+static inline cgm_quat from_euler(float x, float y, float z) {
+    float sx, sy, sz, cx, cy, cz;
+    cgm_sincos(x * 0.5F, &sx, &cx);
+    cgm_sincos(y * 0.5F, &sy, &cy);
+    cgm_sincos(z * 0.5F, &sz, &cz);
+    return compose_euler(sx, cx, sy, cy, sz, cz);
+}
+
+/**
+ * Branch-free form of from_euler() for the batch loops. ok is cleared if
+ * an angle was out of the range of cgm_sincos_fast(), in which case the
+ * result is not valid.
+ */
+static inline cgm_quat from_euler_fast(float x, float y, float z, int* ok) {
+    float sx, sy, sz, cx, cy, cz;
+    *ok &= cgm_sincos_fast(x * 0.5F, &sx, &cx)
+        & cgm_sincos_fast(y * 0.5F, &sy, &cy)
+        & cgm_sincos_fast(z * 0.5F, &sz, &cz);
+    return compose_euler(sx, cx, sy, cy, sz, cz);
+}
+
+static inline void to_euler(cgm_quat q, float* x, float* y, float* z) {
+    /* Clamp to keep asinf() defined when rounding pushes a unit
+     * quaternion at gimbal lock slightly past +/-1.
+     */
+    float sin_y = 2.0F * (q.w * q.y - q.z * q.x);
+    sin_y = sin_y > 1.0F ? 1.0F : sin_y;
+    sin_y = sin_y < -1.0F ? -1.0F : sin_y;
+
+    *x = atan2f(2.0F * (q.w * q.x + q.y * q.z),
+            1.0F - 2.0F * (q.x * q.x + q.y * q.y));
+    *y = asinf(sin_y);
+    *z = atan2f(2.0F * (q.w * q.z + q.x * q.y),
+            1.0F - 2.0F * (q.y * q.y + q.z * q.z));
+}
+
+/**
+ * Interpolation kernels shared by the single and SoA versions.
+ * Quaternions are passed by value so that the SoA loops can keep them in
+ * registers.
+ */
+static inline cgm_quat nlerp(cgm_quat p, cgm_quat q, float t) {
+    float d = p.w * q.w + p.x * q.x + p.y * q.y + p.z * q.z;
+
+    /* Take the shortest arc */
+    float s = d < 0.0F ? -t : t;
+    float r = 1.0F - t;
+
+    cgm_quat out;
+    out.w = r * p.w + s * q.w;
+    out.x = r * p.x + s * q.x;
+    out.y = r * p.y + s * q.y;
+    out.z = r * p.z + s * q.z;
+
+    float inv_mag = 1.0F / sqrtf(out.w * out.w + out.x * out.x
+            + out.y * out.y + out.z * out.z);
+    out.w *= inv_mag;
+    out.x *= inv_mag;
+    out.y *= inv_mag;
+    out.z *= inv_mag;
+    return out;
+}
+
+static inline cgm_quat slerp(cgm_quat p, cgm_quat q, float t) {
+    float d = p.w * q.w + p.x * q.x + p.y * q.y + p.z * q.z;
+    float sign = 1.0F;
+    if (d < 0.0F) {
+        d = -d;
+        sign = -1.0F;
+    }
+
+    /* sin(theta) is too small to divide by, but the arc is close enough
+     * to a line here
+     */
+    if (d > 0.9995F) {
+        return nlerp(p, q, t);
+    }
+
+    float theta = acosf(d);
+    float inv_sin = 1.0F / sqrtf(1.0F - d * d);
+    float s0 = sinf((1.0F - t) * theta) * inv_sin;
+    float s1 = sign * sinf(t * theta) * inv_sin;
+
+    cgm_quat out;
+    out.w = s0 * p.w + s1 * q.w;
+    out.x = s0 * p.x + s1 * q.x;
+    out.y = s0 * p.y + s1 * q.y;
+    out.z = s0 * p.z + s1 * q.z;
+    return out;
+}
+
+/**
+ * Corrects t so that nlerp has nearly constant angular velocity.
+ * The correction is a cubic in t which vanishes at 0, 1/2 and 1, scaled
+ * by a factor fit to |p . q|. See "Approximating slerp" by Arseny
+ * Kapoulkine.
+ */
+static inline cgm_quat slerp_fast(cgm_quat p, cgm_quat q, float t) {
+    float d = fabsf(p.w * q.w + p.x * q.x + p.y * q.y + p.z * q.z);
+    float a = 1.0904F + d * (-3.2452F + d * (3.55645F - d * 1.43519F));
+    float b = 0.848013F + d * (-1.06021F + d * 0.215638F);
+    float k = a * (t - 0.5F) * (t - 0.5F) + b;
+
+    return nlerp(p, q, t + t * (t - 0.5F) * (t - 1.0F) * k);
+}
+
+/**
+ * 1 / sqrt(s) for s near 1, by a Newton step from the tangent line at 1.
+ */
+static inline float rsqrt_near_one(float s) {
+    float y = 1.5F - 0.5F * s;
+    return y * (1.5F - 0.5F * s * y * y);
+}
+
+static inline cgm_quat renormalize(cgm_quat q) {
+    float r = rsqrt_near_one(
+            q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    q.w *= r;
+    q.x *= r;
+    q.y *= r;
+    q.z *= r;
+    return q;
+}
+
+/**
+ * q + h (0, (x, y, z)) q, renormalized.
+ */
+static inline cgm_quat integrate(cgm_quat q,
+        float x, float y, float z, float h) {
+    cgm_quat out;
+    out.w = q.w - h * (x * q.x + y * q.y + z * q.z);
+    out.x = q.x + h * (x * q.w + y * q.z - z * q.y);
+    out.y = q.y + h * (y * q.w + z * q.x - x * q.z);
+    out.z = q.z + h * (z * q.w + x * q.y - y * q.x);
+    return renormalize(out);
+}
 
 void cgm_quat_set(cgm_quat* q,
         float w, float x, float y, float z) {
@@ -29,18 +180,70 @@ void cgm_quat_set_identity(cgm_quat* q) {
 }
 
 void cgm_quat_from_euler(cgm_quat* q, float x, float y, float z) {
-    float sx = sinf(x / 2.0F);
-    float sy = sinf(y / 2.0F);
-    float sz = sinf(z / 2.0F);
-    float cx = cosf(x / 2.0F);
-    float cy = cosf(y / 2.0F);
-    float cz = cosf(z / 2.0F);
+    *q = from_euler(x, y, z);
+}
 
-    cgm_quat_set(q,
-            cx * cy * cz + sx * sy * sz,
-            sx * cy * cz - cx * sy * sz,
-            cx * sy * cz + sx * cy * sz,
-            cx * cy * sz - sx * sy * cz);
+void cgm_quat_from_euler_n(cgm_quat* q, const cgm_vec3* angles, size_t n) {
+    int ok = 1;
+
+    #pragma omp simd simdlen(8) reduction(&:ok)
+    for (size_t i = 0; i < n; i++) {
+        q[i] = from_euler_fast(angles[i].x, angles[i].y, angles[i].z, &ok);
+    }
+
+    /* Rare: redo the batch with the C library for the huge angles */
+    if (!ok) {
+        for (size_t i = 0; i < n; i++) {
+            q[i] = from_euler(angles[i].x, angles[i].y, angles[i].z);
+        }
+    }
+}
+
+void cgm_quat_soa_from_euler(cgm_quat_soa* q, const cgm_vec3_soa* angles,
+        size_t n) {
+    const float* x = angles->x;
+    const float* y = angles->y;
+    const float* z = angles->z;
+
+    int ok = 1;
+
+    #pragma omp simd simdlen(8) reduction(&:ok)
+    for (size_t i = 0; i < n; i++) {
+        cgm_quat r = from_euler_fast(x[i], y[i], z[i], &ok);
+        q->w[i] = r.w;
+        q->x[i] = r.x;
+        q->y[i] = r.y;
+        q->z[i] = r.z;
+    }
+
+    /* Rare: redo the batch with the C library for the huge angles */
+    if (!ok) {
+        for (size_t i = 0; i < n; i++) {
+            cgm_quat r = from_euler(x[i], y[i], z[i]);
+            q->w[i] = r.w;
+            q->x[i] = r.x;
+            q->y[i] = r.y;
+            q->z[i] = r.z;
+        }
+    }
+}
+
+void cgm_quat_to_euler(const cgm_quat* q, float* x, float* y, float* z) {
+    to_euler(*q, x, y, z);
+}
+
+void cgm_quat_to_euler_n(const cgm_quat* q, cgm_vec3* angles, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        to_euler(q[i], &angles[i].x, &angles[i].y, &angles[i].z);
+    }
+}
+
+void cgm_quat_soa_to_euler(const cgm_quat_soa* q, cgm_vec3_soa* angles,
+        size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        cgm_quat r = {{q->w[i], {{q->x[i], q->y[i], q->z[i]}}}};
+        to_euler(r, &angles->x[i], &angles->y[i], &angles->z[i]);
+    }
 }
 
 void cgm_quat_from_axis_angle(cgm_quat* q,
@@ -54,9 +257,12 @@ void cgm_quat_from_axis_angle(cgm_quat* q,
     /* Do the operation once */
     angle /= 2.0F;
 
-    float s_mag = sinf(angle) / mag;
+    float s, c;
+    cgm_sincos(angle, &s, &c);
+
+    float s_mag = s / mag;
     cgm_quat_set(q,
-            cosf(angle),
+            c,
             axis->x * s_mag,
             axis->y * s_mag,
             axis->z * s_mag);
@@ -100,6 +306,52 @@ void cgm_quat_scale(cgm_quat* q, float val) {
     q->z *= val;
 }
 
+void cgm_quat_normalize(cgm_quat* q) {
+    float mag = cgm_quat_mag(q);
+    if (mag != 0) {
+        cgm_quat_scale(q, 1 / mag);
+    }
+}
+
+void cgm_quat_soa_renormalize(cgm_quat_soa* q, size_t n) {
+    float* qw = q->w;
+    float* qx = q->x;
+    float* qy = q->y;
+    float* qz = q->z;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_quat a = {{qw[i], {{qx[i], qy[i], qz[i]}}}};
+        cgm_quat r = renormalize(a);
+        qw[i] = r.w;
+        qx[i] = r.x;
+        qy[i] = r.y;
+        qz[i] = r.z;
+    }
+}
+
+void cgm_quat_soa_integrate(cgm_quat_soa* q,
+        const cgm_vec3_soa* omega, float dt, size_t n) {
+    float* qw = q->w;
+    float* qx = q->x;
+    float* qy = q->y;
+    float* qz = q->z;
+    const float* x = omega->x;
+    const float* y = omega->y;
+    const float* z = omega->z;
+    float h = 0.5F * dt;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_quat a = {{qw[i], {{qx[i], qy[i], qz[i]}}}};
+        cgm_quat r = integrate(a, x[i], y[i], z[i], h);
+        qw[i] = r.w;
+        qx[i] = r.x;
+        qy[i] = r.y;
+        qz[i] = r.z;
+    }
+}
+
 void cgm_quat_mul(cgm_quat* out,
         const cgm_quat* p,
         const cgm_quat* q) {
@@ -129,6 +381,90 @@ void cgm_quat_rotate(cgm_quat* q,
     cgm_quat_mul_l(q, &tmp);
 }
 
+void cgm_quat_rotate_v3(const cgm_quat* q, cgm_vec3* v) {
+    cgm_rotate_v3(q->w, q->x, q->y, q->z, &v->x, &v->y, &v->z);
+}
+
+void cgm_quat_rotate_v3_n(const cgm_quat* q, cgm_vec3* v, size_t n) {
+    float w = q->w, qx = q->x, qy = q->y, qz = q->z;
+    for (size_t i = 0; i < n; i++) {
+        cgm_rotate_v3(w, qx, qy, qz, &v[i].x, &v[i].y, &v[i].z);
+    }
+}
+
+void cgm_quat_rotate_v3_soa(const cgm_quat* q, cgm_vec3_soa* v, size_t n) {
+    float w = q->w, qx = q->x, qy = q->y, qz = q->z;
+    float* x = v->x;
+    float* y = v->y;
+    float* z = v->z;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_rotate_v3(w, qx, qy, qz, &x[i], &y[i], &z[i]);
+    }
+}
+
+void cgm_quat_soa_rotate_v3(const cgm_quat_soa* q, cgm_vec3_soa* v,
+        size_t n) {
+    const float* qw = q->w;
+    const float* qx = q->x;
+    const float* qy = q->y;
+    const float* qz = q->z;
+    float* x = v->x;
+    float* y = v->y;
+    float* z = v->z;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        cgm_rotate_v3(qw[i], qx[i], qy[i], qz[i], &x[i], &y[i], &z[i]);
+    }
+}
+
+void cgm_quat_slerp(cgm_quat* out,
+        const cgm_quat* p,
+        const cgm_quat* q,
+        float t) {
+    *out = slerp(*p, *q, t);
+}
+
+void cgm_quat_nlerp(cgm_quat* out,
+        const cgm_quat* p,
+        const cgm_quat* q,
+        float t) {
+    *out = nlerp(*p, *q, t);
+}
+
+void cgm_quat_slerp_fast(cgm_quat* out,
+        const cgm_quat* p,
+        const cgm_quat* q,
+        float t) {
+    *out = slerp_fast(*p, *q, t);
+}
+
+void cgm_quat_soa_slerp(cgm_quat_soa* out,
+        const cgm_quat_soa* p,
+        const cgm_quat_soa* q,
+        const float* t,
+        size_t n) {
+    SOA_INTERPOLATE(cgm_quat, slerp, out, p, q, t, n);
+}
+
+void cgm_quat_soa_nlerp(cgm_quat_soa* out,
+        const cgm_quat_soa* p,
+        const cgm_quat_soa* q,
+        const float* t,
+        size_t n) {
+    SOA_INTERPOLATE(cgm_quat, nlerp, out, p, q, t, n);
+}
+
+void cgm_quat_soa_slerp_fast(cgm_quat_soa* out,
+        const cgm_quat_soa* p,
+        const cgm_quat_soa* q,
+        const float* t,
+        size_t n) {
+    SOA_INTERPOLATE(cgm_quat, slerp_fast, out, p, q, t, n);
+}
+
 int cgm_quat_fprintf(FILE* stream, const cgm_quat* q) {
     return fprintf(stream, "(%g, %g, %g, %g)\n", q->x, q->y, q->z, q->w);
 }
@@ -9,6 +9,7 @@
 #define QUATERNION_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "../vector/vec3.h"
 
@@ -50,6 +51,19 @@ typedef union cgm_quat {
 
 #define CGM_QUAT(W, X, Y, Z) ((const cgm_quat*) &((cgm_quat) {{(W), (X), (Y), (Z)}}))
 
+/**
+ * Structure-of-arrays view of a sequence of cgm_quat's.
+ * Each pointer refers to an array of the same length holding one
+ * component of every quaternion. As with cgm_vec3_soa, the arrays
+ * must not overlap.
+ */
+typedef struct cgm_quat_soa {
+    float* w;
+    float* x;
+    float* y;
+    float* z;
+} cgm_quat_soa;
+
 /**
  * Sets the components of a quaternion.
  * @param q - The quaternion to set.
@@ -85,6 +99,60 @@ void cgm_quat_set_identity(cgm_quat* q);
  */
 void cgm_quat_from_euler(cgm_quat* q, float x, float y, float z);
 
+/**
+ * Sets an array of quaternions from Euler angles.
+ * q[i] is set as by cgm_quat_from_euler() with the x, y, and z components
+ * of angles[i]. The half-angle sines and cosines of all three angles are
+ * evaluated by a branch-free polynomial, several quaternions at a time.
+ * @param q - Array of n quaternions to set.
+ * @param angles - Array of n angle triples (in radians).
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_from_euler_n(cgm_quat* q, const cgm_vec3* angles, size_t n);
+
+/**
+ * Sets quaternions stored as a structure of arrays from Euler angles
+ * stored the same way.
+ * This is the SoA form of cgm_quat_from_euler_n().
+ * @param q - Arrays of n quaternions to set.
+ * @param angles - Arrays of n angle triples (in radians).
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_soa_from_euler(cgm_quat_soa* q, const cgm_vec3_soa* angles,
+        size_t n);
+
+/**
+ * Extracts the Euler angles of a unit quaternion.
+ * This is the inverse of cgm_quat_from_euler(): x and z are in
+ * [-pi, pi] and y is in [-pi/2, pi/2]. When y is +/-pi/2 (gimbal lock),
+ * x and z are not unique and only their combination is meaningful.
+ * @param q - Unit quaternion to extract from.
+ * @param x - Pointer to store the angle around the x axis.
+ * @param y - Pointer to store the angle around the y axis.
+ * @param z - Pointer to store the angle around the z axis.
+ */
+void cgm_quat_to_euler(const cgm_quat* q, float* x, float* y, float* z);
+
+/**
+ * Extracts the Euler angles of an array of unit quaternions.
+ * angles[i] is set as by cgm_quat_to_euler() on q[i].
+ * @param q - Array of n unit quaternions.
+ * @param angles - Array of n angle triples to set.
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_to_euler_n(const cgm_quat* q, cgm_vec3* angles, size_t n);
+
+/**
+ * Extracts the Euler angles of unit quaternions stored as a structure of
+ * arrays.
+ * This is the SoA form of cgm_quat_to_euler_n().
+ * @param q - Arrays of n unit quaternions.
+ * @param angles - Arrays of n angle triples to set.
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_soa_to_euler(const cgm_quat_soa* q, cgm_vec3_soa* angles,
+        size_t n);
+
 /**
  * Sets a quaternion to a rotation of a specified angle around a
  * specified axis.
@@ -142,6 +210,42 @@ float cgm_quat_mag(const cgm_quat* q);
  */
 void cgm_quat_scale(cgm_quat* q, float val);
 
+/**
+ * Normalizes a quaternion to unit magnitude.
+ * A quaternion of magnitude 0 is left unchanged.
+ * @param q - The quaternion to normalize.
+ */
+void cgm_quat_normalize(cgm_quat* q);
+
+/**
+ * Renormalizes quaternions stored as structures of arrays which have
+ * drifted slightly from unit magnitude, such as after integration or
+ * repeated multiplication.
+ * The inverse square root of the squared magnitude is taken by a Newton
+ * step from 1 rather than by a square root and division, which is exact
+ * to rounding while the squared magnitudes are within a few percent of 1
+ * and degrades beyond that. Use cgm_quat_normalize() for quaternions
+ * which may be far from unit magnitude.
+ * @param q - Arrays of n quaternions to renormalize.
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_soa_renormalize(cgm_quat_soa* q, size_t n);
+
+/**
+ * Advances unit quaternions stored as structures of arrays by angular
+ * velocities over a time step.
+ * Each q[i] is set to q[i] + dt / 2 (0, omega[i]) q[i] and renormalized
+ * as by cgm_quat_soa_renormalize(), which is accurate while
+ * |omega[i]| dt stays below about 0.5 radians.
+ * @param q - Arrays of n orientations to advance.
+ * @param omega - Arrays of n angular velocities, in radians per unit of
+ *                time, in the same (world) frame that q rotates into.
+ * @param dt - Time step.
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_soa_integrate(cgm_quat_soa* q,
+        const cgm_vec3_soa* omega, float dt, size_t n);
+
 /**
  * Multiplies two quaternions.
  * The operation `out = p * q' is performed.
@@ -179,6 +283,146 @@ void cgm_quat_rotate(cgm_quat* q,
         const cgm_vec3* axis,
         float angle);
 
+/**
+ * Rotates a cgm_vec3 by a unit quaternion.
+ * This computes q * v * q^-1 directly as
+ * `v + 2w(q.xyz x v) + 2 q.xyz x (q.xyz x v)', without building a
+ * rotation matrix.
+ * @param q - Unit quaternion to rotate by.
+ * @param v - Vector to rotate.
+ */
+void cgm_quat_rotate_v3(const cgm_quat* q, cgm_vec3* v);
+
+/**
+ * Rotates an array of cgm_vec3's by the same unit quaternion.
+ * @param q - Unit quaternion to rotate by.
+ * @param v - Array of n vectors to rotate.
+ * @param n - Number of vectors.
+ */
+void cgm_quat_rotate_v3_n(const cgm_quat* q, cgm_vec3* v, size_t n);
+
+/**
+ * Rotates vectors stored as a structure of arrays by the same unit
+ * quaternion.
+ * @param q - Unit quaternion to rotate by.
+ * @param v - Arrays of n vectors to rotate.
+ * @param n - Number of vectors.
+ */
+void cgm_quat_rotate_v3_soa(const cgm_quat* q, cgm_vec3_soa* v, size_t n);
+
+/**
+ * Rotates each vector of a structure of arrays by the corresponding
+ * unit quaternion of another.
+ * v[i] is rotated by q[i].
+ * @param q - Arrays of n unit quaternions to rotate by.
+ * @param v - Arrays of n vectors to rotate.
+ * @param n - Number of quaternion/vector pairs.
+ */
+void cgm_quat_soa_rotate_v3(const cgm_quat_soa* q, cgm_vec3_soa* v,
+        size_t n);
+
+/**
+ * Spherically interpolates between two unit quaternions.
+ * The interpolation follows the shortest arc: if p and q are more than
+ * half a turn apart, -q is used instead of q. Nearly identical
+ * quaternions fall back to cgm_quat_nlerp().
+ * out may be the same as p or q.
+ * @param out - The quaternion to store the result.
+ * @param p - The quaternion at t = 0.
+ * @param q - The quaternion at t = 1.
+ * @param t - Interpolation parameter in [0, 1].
+ */
+void cgm_quat_slerp(cgm_quat* out,
+        const cgm_quat* p,
+        const cgm_quat* q,
+        float t);
+
+/**
+ * Linearly interpolates between two unit quaternions and normalizes the
+ * result.
+ * This follows the same path as cgm_quat_slerp() (including the
+ * shortest arc handling) but not at constant angular velocity.
+ * out may be the same as p or q.
+ * @param out - The quaternion to store the result.
+ * @param p - The quaternion at t = 0.
+ * @param q - The quaternion at t = 1.
+ * @param t - Interpolation parameter in [0, 1].
+ */
+void cgm_quat_nlerp(cgm_quat* out,
+        const cgm_quat* p,
+        const cgm_quat* q,
+        float t);
+
+/**
+ * Approximates cgm_quat_slerp() without any trigonometric functions.
+ * The interpolation parameter is corrected by a polynomial in t and
+ * |p . q| before a cgm_quat_nlerp(), which brings the angular velocity
+ * close to constant. Each component of the result is within 4e-4 of
+ * cgm_quat_slerp() for any pair of unit quaternions.
+ * out may be the same as p or q.
+ * @param out - The quaternion to store the result.
+ * @param p - The quaternion at t = 0.
+ * @param q - The quaternion at t = 1.
+ * @param t - Interpolation parameter in [0, 1].
+ */
+void cgm_quat_slerp_fast(cgm_quat* out,
+        const cgm_quat* p,
+        const cgm_quat* q,
+        float t);
+
+/**
+ * Spherically interpolates between pairs of quaternions stored as
+ * structures of arrays.
+ * out[i] is set to cgm_quat_slerp(p[i], q[i], t[i]).
+ * out may be the same as p or q.
+ * @param out - Arrays of n quaternions to store the results.
+ * @param p - Arrays of n quaternions at t = 0.
+ * @param q - Arrays of n quaternions at t = 1.
+ * @param t - Array of n interpolation parameters.
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_soa_slerp(cgm_quat_soa* out,
+        const cgm_quat_soa* p,
+        const cgm_quat_soa* q,
+        const float* t,
+        size_t n);
+
+/**
+ * Normalized linear interpolation of quaternions stored as structures of
+ * arrays.
+ * out[i] is set to cgm_quat_nlerp(p[i], q[i], t[i]).
+ * out may be the same as p or q.
+ * @param out - Arrays of n quaternions to store the results.
+ * @param p - Arrays of n quaternions at t = 0.
+ * @param q - Arrays of n quaternions at t = 1.
+ * @param t - Array of n interpolation parameters.
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_soa_nlerp(cgm_quat_soa* out,
+        const cgm_quat_soa* p,
+        const cgm_quat_soa* q,
+        const float* t,
+        size_t n);
+
+/**
+ * Approximate spherical interpolation of quaternions stored as
+ * structures of arrays.
+ * out[i] is set to cgm_quat_slerp_fast(p[i], q[i], t[i]). Unlike
+ * cgm_quat_soa_slerp(), this needs no calls into libm and so vectorizes
+ * fully.
+ * out may be the same as p or q.
+ * @param out - Arrays of n quaternions to store the results.
+ * @param p - Arrays of n quaternions at t = 0.
+ * @param q - Arrays of n quaternions at t = 1.
+ * @param t - Array of n interpolation parameters.
+ * @param n - Number of quaternions.
+ */
+void cgm_quat_soa_slerp_fast(cgm_quat_soa* out,
+        const cgm_quat_soa* p,
+        const cgm_quat_soa* q,
+        const float* t,
+        size_t n);
+
 /**
  * Prints a cgm_quat to a stream.
  * The quaternion is printed as "(x, y, z, w)\n" to the stream in "%g" format.
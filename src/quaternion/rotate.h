@@ -0,0 +1,35 @@
+/**
+ * rotate.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Internal quaternion-vector rotation kernel shared by the quaternion and
+ * skinning code. This header is not installed.
+ */
+
+#ifndef ROTATE_H_
+#define ROTATE_H_
+
+/**
+ * Rotates the vector (x, y, z) by the unit quaternion (w, qx, qy, qz).
+ * Computes t = 2 (q x v), then v' = v + w t + q x t.
+ * Works on plain floats so that the batch loops can inline and vectorize
+ * it.
+ */
+static inline void cgm_rotate_v3(float w, float qx, float qy, float qz,
+        float* x, float* y, float* z) {
+    float vx = *x, vy = *y, vz = *z;
+
+    float tx = 2.0F * (qy * vz - qz * vy);
+    float ty = 2.0F * (qz * vx - qx * vz);
+    float tz = 2.0F * (qx * vy - qy * vx);
+
+    *x = vx + w * tx + (qy * tz - qz * ty);
+    *y = vy + w * ty + (qz * tx - qx * tz);
+    *z = vz + w * tz + (qx * ty - qy * tx);
+}
+
+#endif /* ROTATE_H_ */
+
+/* vim: set ft=c: */
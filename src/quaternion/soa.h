@@ -0,0 +1,36 @@
+/**
+ * soa.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Internal loop shared by the float and double SoA quaternion
+ * interpolations. This header is not installed.
+ */
+
+#ifndef QUATERNION_SOA_H_
+#define QUATERNION_SOA_H_
+
+#include <stddef.h>
+
+/**
+ * Applies an interpolation kernel across SoA quaternions: for each i,
+ * the TYPE quaternions at i of P and Q are interpolated by T[i] and the
+ * result stored at i of OUT.
+ */
+#define SOA_INTERPOLATE(TYPE, KERNEL, OUT, P, Q, T, N) do { \
+    _Pragma("omp simd") \
+    for (size_t i = 0; i < (N); i++) { \
+        TYPE a = {{(P)->w[i], {{(P)->x[i], (P)->y[i], (P)->z[i]}}}}; \
+        TYPE b = {{(Q)->w[i], {{(Q)->x[i], (Q)->y[i], (Q)->z[i]}}}}; \
+        TYPE r = KERNEL(a, b, (T)[i]); \
+        (OUT)->w[i] = r.w; \
+        (OUT)->x[i] = r.x; \
+        (OUT)->y[i] = r.y; \
+        (OUT)->z[i] = r.z; \
+    } \
+} while (0)
+
+#endif /* QUATERNION_SOA_H_ */
+
+/* vim: set ft=c: */
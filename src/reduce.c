@@ -0,0 +1,355 @@
+/**
+ * reduce.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "vector/vec3.h"
+#include "vector/vec4.h"
+#include "vector/dvec3.h"
+#include "pool.h"
+#include "reduce.h"
+
+/**
+ * Result of reducing one block.
+ * Every reduction uses this so that one driver can run them all. Float
+ * minimums and maximums are widened to double exactly.
+ */
+typedef struct partial {
+    double a[4];
+    double b[4];
+} partial;
+
+struct reduction;
+
+typedef void (*block_fn)(const struct reduction* r,
+        size_t begin, size_t end, partial* out);
+typedef void (*combine_fn)(partial* acc, const partial* p);
+
+struct reduction {
+    const void* u;
+    const void* v;
+    size_t n;
+    block_fn block;
+    partial* partials;
+};
+
+static void combine_sum(partial* acc, const partial* p) {
+    for (int k = 0; k < 4; k++) {
+        acc->a[k] += p->a[k];
+    }
+}
+
+static void combine_bounds(partial* acc, const partial* p) {
+    for (int k = 0; k < 4; k++) {
+        acc->a[k] = p->a[k] < acc->a[k] ? p->a[k] : acc->a[k];
+        acc->b[k] = p->b[k] > acc->b[k] ? p->b[k] : acc->b[k];
+    }
+}
+
+static void combine_max(partial* acc, const partial* p) {
+    acc->a[0] = p->a[0] > acc->a[0] ? p->a[0] : acc->a[0];
+}
+
+/**
+ * Reduces block i into p.
+ */
+static void run_block(const struct reduction* r, size_t i, partial* p) {
+    size_t begin = i * CGM_REDUCE_BLOCK;
+    size_t end = r->n - begin > CGM_REDUCE_BLOCK ?
+        begin + CGM_REDUCE_BLOCK : r->n;
+    r->block(r, begin, end, p);
+}
+
+static void run_chunk(void* ctx, size_t begin, size_t end) {
+    struct reduction* r = ctx;
+    r->block(r, begin, end, &r->partials[begin / CGM_REDUCE_BLOCK]);
+}
+
+/**
+ * Reduces n elements block by block and combines the partial results in
+ * block order.
+ * The serial path combines as it goes and the threaded path combines
+ * once all blocks are done, but the order is the same, and so is the
+ * result.
+ */
+static partial reduce(const void* u, const void* v, size_t n,
+        block_fn block, combine_fn combine, cgm_pool* pool) {
+    size_t blocks = (n + CGM_REDUCE_BLOCK - 1) / CGM_REDUCE_BLOCK;
+    struct reduction r = {u, v, n, block, NULL};
+    partial out;
+
+    if (blocks <= 1) {
+        block(&r, 0, n, &out);
+        return out;
+    }
+
+    if (cgm_pool_threads(pool) > 1) {
+        r.partials = malloc(blocks * sizeof(partial));
+    }
+
+    if (r.partials != NULL) {
+        cgm_parallel_for(pool, n, CGM_REDUCE_BLOCK, run_chunk, &r);
+        out = r.partials[0];
+        for (size_t i = 1; i < blocks; i++) {
+            combine(&out, &r.partials[i]);
+        }
+
+        free(r.partials);
+    } else {
+        run_block(&r, 0, &out);
+        for (size_t i = 1; i < blocks; i++) {
+            partial p;
+            run_block(&r, i, &p);
+            combine(&out, &p);
+        }
+    }
+
+    return out;
+}
+
+/*
+ * Block kernels.
+ * LOCALS declares the pointers the element expressions use; the
+ * expressions may refer to the element index i. Unused components are
+ * given as 0.
+ */
+
+#define SUM_BLOCK(NAME, SCALAR, LOCALS, X, Y, Z, W) \
+static void NAME(const struct reduction* r, \
+        size_t begin, size_t end, partial* out) { \
+    LOCALS; \
+    SCALAR x = 0, y = 0, z = 0, w = 0; \
+    _Pragma("omp simd reduction(+:x, y, z, w)") \
+    for (size_t i = begin; i < end; i++) { \
+        x += (X); \
+        y += (Y); \
+        z += (Z); \
+        w += (W); \
+    } \
+    *out = (partial) {{x, y, z, w}, {0, 0, 0, 0}}; \
+}
+
+#define BOUNDS_BLOCK(NAME, SCALAR, LOCALS, X, Y, Z, W) \
+static void NAME(const struct reduction* r, \
+        size_t begin, size_t end, partial* out) { \
+    LOCALS; \
+    SCALAR lx = INFINITY, ly = INFINITY, lz = INFINITY, lw = INFINITY; \
+    SCALAR hx = -INFINITY, hy = -INFINITY, hz = -INFINITY, hw = -INFINITY; \
+    _Pragma("omp simd reduction(min:lx,ly,lz,lw) reduction(max:hx,hy,hz,hw)") \
+    for (size_t i = begin; i < end; i++) { \
+        SCALAR x = (X), y = (Y), z = (Z), w = (W); \
+        lx = x < lx ? x : lx; \
+        ly = y < ly ? y : ly; \
+        lz = z < lz ? z : lz; \
+        lw = w < lw ? w : lw; \
+        hx = x > hx ? x : hx; \
+        hy = y > hy ? y : hy; \
+        hz = z > hz ? z : hz; \
+        hw = w > hw ? w : hw; \
+    } \
+    *out = (partial) {{lx, ly, lz, lw}, {hx, hy, hz, hw}}; \
+}
+
+#define DOT_BLOCK(NAME, SCALAR, LOCALS, EXPR) \
+static void NAME(const struct reduction* r, \
+        size_t begin, size_t end, partial* out) { \
+    LOCALS; \
+    SCALAR d = 0; \
+    _Pragma("omp simd reduction(+:d)") \
+    for (size_t i = begin; i < end; i++) { \
+        d += (EXPR); \
+    } \
+    *out = (partial) {{d, 0, 0, 0}, {0, 0, 0, 0}}; \
+}
+
+#define MAX_BLOCK(NAME, SCALAR, LOCALS, EXPR) \
+static void NAME(const struct reduction* r, \
+        size_t begin, size_t end, partial* out) { \
+    LOCALS; \
+    SCALAR m = 0; \
+    _Pragma("omp simd reduction(max:m)") \
+    for (size_t i = begin; i < end; i++) { \
+        SCALAR e = (EXPR); \
+        m = e > m ? e : m; \
+    } \
+    *out = (partial) {{m, 0, 0, 0}, {0, 0, 0, 0}}; \
+}
+
+#define VEC3_LOCALS const cgm_vec3* v = r->v
+#define VEC3_DOT_LOCALS VEC3_LOCALS; const cgm_vec3* u = r->u
+#define VEC3_MAG2 v[i].x * v[i].x + v[i].y * v[i].y + v[i].z * v[i].z
+#define VEC3_DOT u[i].x * v[i].x + u[i].y * v[i].y + u[i].z * v[i].z
+
+SUM_BLOCK(vec3_sum, float, VEC3_LOCALS, v[i].x, v[i].y, v[i].z, 0)
+BOUNDS_BLOCK(vec3_bounds, float, VEC3_LOCALS, v[i].x, v[i].y, v[i].z, 0)
+MAX_BLOCK(vec3_max_mag2, float, VEC3_LOCALS, VEC3_MAG2)
+DOT_BLOCK(vec3_dot, float, VEC3_DOT_LOCALS, VEC3_DOT)
+
+#define VEC4_LOCALS const cgm_vec4* v = r->v
+#define VEC4_DOT_LOCALS VEC4_LOCALS; const cgm_vec4* u = r->u
+#define VEC4_MAG2 v[i].x * v[i].x + v[i].y * v[i].y \
+    + v[i].z * v[i].z + v[i].w * v[i].w
+#define VEC4_DOT u[i].x * v[i].x + u[i].y * v[i].y \
+    + u[i].z * v[i].z + u[i].w * v[i].w
+
+SUM_BLOCK(vec4_sum, float, VEC4_LOCALS, v[i].x, v[i].y, v[i].z, v[i].w)
+BOUNDS_BLOCK(vec4_bounds, float, VEC4_LOCALS,
+        v[i].x, v[i].y, v[i].z, v[i].w)
+MAX_BLOCK(vec4_max_mag2, float, VEC4_LOCALS, VEC4_MAG2)
+DOT_BLOCK(vec4_dot, float, VEC4_DOT_LOCALS, VEC4_DOT)
+
+#define DVEC3_LOCALS const cgm_dvec3* v = r->v
+#define DVEC3_DOT_LOCALS DVEC3_LOCALS; const cgm_dvec3* u = r->u
+
+SUM_BLOCK(dvec3_sum, double, DVEC3_LOCALS, v[i].x, v[i].y, v[i].z, 0)
+BOUNDS_BLOCK(dvec3_bounds, double, DVEC3_LOCALS, v[i].x, v[i].y, v[i].z, 0)
+MAX_BLOCK(dvec3_max_mag2, double, DVEC3_LOCALS, VEC3_MAG2)
+DOT_BLOCK(dvec3_dot, double, DVEC3_DOT_LOCALS, VEC3_DOT)
+
+#define SOA_LOCALS \
+    const cgm_vec3_soa* sv = r->v; \
+    const float* vx = sv->x; \
+    const float* vy = sv->y; \
+    const float* vz = sv->z
+#define SOA_DOT_LOCALS \
+    SOA_LOCALS; \
+    const cgm_vec3_soa* su = r->u; \
+    const float* ux = su->x; \
+    const float* uy = su->y; \
+    const float* uz = su->z
+#define SOA_MAG2 vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]
+#define SOA_DOT ux[i] * vx[i] + uy[i] * vy[i] + uz[i] * vz[i]
+
+SUM_BLOCK(soa_sum, float, SOA_LOCALS, vx[i], vy[i], vz[i], 0)
+BOUNDS_BLOCK(soa_bounds, float, SOA_LOCALS, vx[i], vy[i], vz[i], 0)
+MAX_BLOCK(soa_max_mag2, float, SOA_LOCALS, SOA_MAG2)
+DOT_BLOCK(soa_dot, float, SOA_DOT_LOCALS, SOA_DOT)
+
+void cgm_vec3_bounds_n(cgm_vec3* min, cgm_vec3* max,
+        const cgm_vec3* v, size_t n, cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, vec3_bounds, combine_bounds, pool);
+    cgm_vec3_set(min, p.a[0], p.a[1], p.a[2]);
+    cgm_vec3_set(max, p.b[0], p.b[1], p.b[2]);
+}
+
+void cgm_vec3_sum_n(cgm_vec3* sum, const cgm_vec3* v, size_t n,
+        cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, vec3_sum, combine_sum, pool);
+    cgm_vec3_set(sum, p.a[0], p.a[1], p.a[2]);
+}
+
+void cgm_vec3_mean_n(cgm_vec3* mean, const cgm_vec3* v, size_t n,
+        cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, vec3_sum, combine_sum, pool);
+    double inv_n = n > 0 ? 1.0 / n : 0.0;
+    cgm_vec3_set(mean, p.a[0] * inv_n, p.a[1] * inv_n, p.a[2] * inv_n);
+}
+
+float cgm_vec3_max_mag_n(const cgm_vec3* v, size_t n, cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, vec3_max_mag2, combine_max, pool);
+    return sqrtf(p.a[0]);
+}
+
+float cgm_vec3_dot_sum_n(const cgm_vec3* u, const cgm_vec3* v, size_t n,
+        cgm_pool* pool) {
+    return reduce(u, v, n, vec3_dot, combine_sum, pool).a[0];
+}
+
+void cgm_vec4_bounds_n(cgm_vec4* min, cgm_vec4* max,
+        const cgm_vec4* v, size_t n, cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, vec4_bounds, combine_bounds, pool);
+    cgm_vec4_set(min, p.a[0], p.a[1], p.a[2], p.a[3]);
+    cgm_vec4_set(max, p.b[0], p.b[1], p.b[2], p.b[3]);
+}
+
+void cgm_vec4_sum_n(cgm_vec4* sum, const cgm_vec4* v, size_t n,
+        cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, vec4_sum, combine_sum, pool);
+    cgm_vec4_set(sum, p.a[0], p.a[1], p.a[2], p.a[3]);
+}
+
+void cgm_vec4_mean_n(cgm_vec4* mean, const cgm_vec4* v, size_t n,
+        cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, vec4_sum, combine_sum, pool);
+    double inv_n = n > 0 ? 1.0 / n : 0.0;
+    cgm_vec4_set(mean, p.a[0] * inv_n, p.a[1] * inv_n,
+            p.a[2] * inv_n, p.a[3] * inv_n);
+}
+
+float cgm_vec4_max_mag_n(const cgm_vec4* v, size_t n, cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, vec4_max_mag2, combine_max, pool);
+    return sqrtf(p.a[0]);
+}
+
+float cgm_vec4_dot_sum_n(const cgm_vec4* u, const cgm_vec4* v, size_t n,
+        cgm_pool* pool) {
+    return reduce(u, v, n, vec4_dot, combine_sum, pool).a[0];
+}
+
+void cgm_dvec3_bounds_n(cgm_dvec3* min, cgm_dvec3* max,
+        const cgm_dvec3* v, size_t n, cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, dvec3_bounds, combine_bounds, pool);
+    cgm_dvec3_set(min, p.a[0], p.a[1], p.a[2]);
+    cgm_dvec3_set(max, p.b[0], p.b[1], p.b[2]);
+}
+
+void cgm_dvec3_sum_n(cgm_dvec3* sum, const cgm_dvec3* v, size_t n,
+        cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, dvec3_sum, combine_sum, pool);
+    cgm_dvec3_set(sum, p.a[0], p.a[1], p.a[2]);
+}
+
+void cgm_dvec3_mean_n(cgm_dvec3* mean, const cgm_dvec3* v, size_t n,
+        cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, dvec3_sum, combine_sum, pool);
+    double inv_n = n > 0 ? 1.0 / n : 0.0;
+    cgm_dvec3_set(mean, p.a[0] * inv_n, p.a[1] * inv_n, p.a[2] * inv_n);
+}
+
+double cgm_dvec3_max_mag_n(const cgm_dvec3* v, size_t n, cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, dvec3_max_mag2, combine_max, pool);
+    return sqrt(p.a[0]);
+}
+
+double cgm_dvec3_dot_sum_n(const cgm_dvec3* u, const cgm_dvec3* v, size_t n,
+        cgm_pool* pool) {
+    return reduce(u, v, n, dvec3_dot, combine_sum, pool).a[0];
+}
+
+void cgm_vec3_soa_bounds(cgm_vec3* min, cgm_vec3* max,
+        const cgm_vec3_soa* v, size_t n, cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, soa_bounds, combine_bounds, pool);
+    cgm_vec3_set(min, p.a[0], p.a[1], p.a[2]);
+    cgm_vec3_set(max, p.b[0], p.b[1], p.b[2]);
+}
+
+void cgm_vec3_soa_sum(cgm_vec3* sum, const cgm_vec3_soa* v, size_t n,
+        cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, soa_sum, combine_sum, pool);
+    cgm_vec3_set(sum, p.a[0], p.a[1], p.a[2]);
+}
+
+void cgm_vec3_soa_mean(cgm_vec3* mean, const cgm_vec3_soa* v, size_t n,
+        cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, soa_sum, combine_sum, pool);
+    double inv_n = n > 0 ? 1.0 / n : 0.0;
+    cgm_vec3_set(mean, p.a[0] * inv_n, p.a[1] * inv_n, p.a[2] * inv_n);
+}
+
+float cgm_vec3_soa_max_mag(const cgm_vec3_soa* v, size_t n, cgm_pool* pool) {
+    partial p = reduce(NULL, v, n, soa_max_mag2, combine_max, pool);
+    return sqrtf(p.a[0]);
+}
+
+float cgm_vec3_soa_dot_sum(const cgm_vec3_soa* u, const cgm_vec3_soa* v,
+        size_t n, cgm_pool* pool) {
+    return reduce(u, v, n, soa_dot, combine_sum, pool).a[0];
+}
+
+/* vim: set ft=c: */
@@ -0,0 +1,262 @@
+/**
+ * reduce.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Reductions over arrays of vectors: bounds, sums, means, maximum
+ * magnitudes, and sums of dot products.
+ *
+ * Each array is reduced in fixed blocks of CGM_REDUCE_BLOCK elements
+ * (vectorized within a block), and the per-block results are combined in
+ * block order. The pool parameter spreads the blocks over its threads;
+ * since the blocks and the combine order do not depend on it, the result
+ * is the same for any pool, or none.
+ * Sums are accumulated in the vector's precision within a block and in
+ * double precision across blocks.
+ */
+
+#ifndef REDUCE_H_
+#define REDUCE_H_
+
+#include <stddef.h>
+
+#include "vector/vec3.h"
+#include "vector/vec4.h"
+#include "vector/dvec3.h"
+#include "pool.h"
+
+/**
+ * Number of elements reduced as one unit of work.
+ */
+#define CGM_REDUCE_BLOCK 8192
+
+/**
+ * Calculates the bounding box of an array of cgm_vec3's.
+ * If n is 0, min is set to +infinity and max to -infinity.
+ * @param min - Vector to store the component-wise minimum.
+ * @param max - Vector to store the component-wise maximum.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec3_bounds_n(cgm_vec3* min, cgm_vec3* max,
+        const cgm_vec3* v, size_t n, cgm_pool* pool);
+
+/**
+ * Calculates the component-wise sum of an array of cgm_vec3's.
+ * @param sum - Vector to store the sum.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec3_sum_n(cgm_vec3* sum, const cgm_vec3* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the mean (centroid) of an array of cgm_vec3's.
+ * If n is 0, mean is set to the zero vector.
+ * @param mean - Vector to store the mean.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec3_mean_n(cgm_vec3* mean, const cgm_vec3* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the largest magnitude among an array of cgm_vec3's.
+ * This is the radius of the smallest origin-centered sphere containing
+ * the vectors.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ * @return The largest magnitude, or 0 if n is 0.
+ */
+float cgm_vec3_max_mag_n(const cgm_vec3* v, size_t n, cgm_pool* pool);
+
+/**
+ * Calculates the sum of the dot products of corresponding vectors in two
+ * arrays.
+ * @param u - First array of n vectors.
+ * @param v - Second array of n vectors.
+ * @param n - Number of vectors in each array.
+ * @param pool - Pool of threads to run on, or NULL.
+ * @return The sum of u[i] . v[i].
+ */
+float cgm_vec3_dot_sum_n(const cgm_vec3* u, const cgm_vec3* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the bounding box of an array of cgm_vec4's.
+ * If n is 0, min is set to +infinity and max to -infinity.
+ * @param min - Vector to store the component-wise minimum.
+ * @param max - Vector to store the component-wise maximum.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec4_bounds_n(cgm_vec4* min, cgm_vec4* max,
+        const cgm_vec4* v, size_t n, cgm_pool* pool);
+
+/**
+ * Calculates the component-wise sum of an array of cgm_vec4's.
+ * @param sum - Vector to store the sum.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec4_sum_n(cgm_vec4* sum, const cgm_vec4* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the mean (centroid) of an array of cgm_vec4's.
+ * If n is 0, mean is set to the zero vector.
+ * @param mean - Vector to store the mean.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec4_mean_n(cgm_vec4* mean, const cgm_vec4* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the largest magnitude among an array of cgm_vec4's.
+ * This is the radius of the smallest origin-centered sphere containing
+ * the vectors.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ * @return The largest magnitude, or 0 if n is 0.
+ */
+float cgm_vec4_max_mag_n(const cgm_vec4* v, size_t n, cgm_pool* pool);
+
+/**
+ * Calculates the sum of the dot products of corresponding vectors in two
+ * arrays.
+ * @param u - First array of n vectors.
+ * @param v - Second array of n vectors.
+ * @param n - Number of vectors in each array.
+ * @param pool - Pool of threads to run on, or NULL.
+ * @return The sum of u[i] . v[i].
+ */
+float cgm_vec4_dot_sum_n(const cgm_vec4* u, const cgm_vec4* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the bounding box of an array of cgm_dvec3's.
+ * If n is 0, min is set to +infinity and max to -infinity.
+ * @param min - Vector to store the component-wise minimum.
+ * @param max - Vector to store the component-wise maximum.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_dvec3_bounds_n(cgm_dvec3* min, cgm_dvec3* max,
+        const cgm_dvec3* v, size_t n, cgm_pool* pool);
+
+/**
+ * Calculates the component-wise sum of an array of cgm_dvec3's.
+ * @param sum - Vector to store the sum.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_dvec3_sum_n(cgm_dvec3* sum, const cgm_dvec3* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the mean (centroid) of an array of cgm_dvec3's.
+ * If n is 0, mean is set to the zero vector.
+ * @param mean - Vector to store the mean.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_dvec3_mean_n(cgm_dvec3* mean, const cgm_dvec3* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the largest magnitude among an array of cgm_dvec3's.
+ * This is the radius of the smallest origin-centered sphere containing
+ * the vectors.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ * @return The largest magnitude, or 0 if n is 0.
+ */
+double cgm_dvec3_max_mag_n(const cgm_dvec3* v, size_t n, cgm_pool* pool);
+
+/**
+ * Calculates the sum of the dot products of corresponding vectors in two
+ * arrays.
+ * @param u - First array of n vectors.
+ * @param v - Second array of n vectors.
+ * @param n - Number of vectors in each array.
+ * @param pool - Pool of threads to run on, or NULL.
+ * @return The sum of u[i] . v[i].
+ */
+double cgm_dvec3_dot_sum_n(const cgm_dvec3* u, const cgm_dvec3* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the bounding box of cgm_vec3's stored as a structure of arrays.
+ * If n is 0, min is set to +infinity and max to -infinity.
+ * @param min - Vector to store the component-wise minimum.
+ * @param max - Vector to store the component-wise maximum.
+ * @param v - Arrays of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec3_soa_bounds(cgm_vec3* min, cgm_vec3* max,
+        const cgm_vec3_soa* v, size_t n, cgm_pool* pool);
+
+/**
+ * Calculates the component-wise sum of cgm_vec3's stored as a structure
+ * of arrays.
+ * @param sum - Vector to store the sum.
+ * @param v - Arrays of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec3_soa_sum(cgm_vec3* sum, const cgm_vec3_soa* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the mean (centroid) of cgm_vec3's stored as a structure of arrays.
+ * If n is 0, mean is set to the zero vector.
+ * @param mean - Vector to store the mean.
+ * @param v - Arrays of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ */
+void cgm_vec3_soa_mean(cgm_vec3* mean, const cgm_vec3_soa* v, size_t n,
+        cgm_pool* pool);
+
+/**
+ * Calculates the largest magnitude among cgm_vec3's stored as a
+ * structure of arrays.
+ * This is the radius of the smallest origin-centered sphere containing
+ * the vectors.
+ * @param v - Arrays of n vectors.
+ * @param n - Number of vectors.
+ * @param pool - Pool of threads to run on, or NULL.
+ * @return The largest magnitude, or 0 if n is 0.
+ */
+float cgm_vec3_soa_max_mag(const cgm_vec3_soa* v, size_t n, cgm_pool* pool);
+
+/**
+ * Calculates the sum of the dot products of corresponding vectors in two
+ * structures of arrays.
+ * @param u - First set of n vectors.
+ * @param v - Second set of n vectors.
+ * @param n - Number of vectors in each set.
+ * @param pool - Pool of threads to run on, or NULL.
+ * @return The sum of u[i] . v[i].
+ */
+float cgm_vec3_soa_dot_sum(const cgm_vec3_soa* u, const cgm_vec3_soa* v,
+        size_t n, cgm_pool* pool);
+
+#endif /* REDUCE_H_ */
+
+/* vim: set ft=c: */
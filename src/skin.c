@@ -0,0 +1,146 @@
+/**
+ * skin.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <math.h>
+#include <stddef.h>
+
+#include "vector/vec3.h"
+#include "vector/vec4.h"
+#include "vector/uvec4.h"
+#include "matrix/mat4.h"
+#include "quaternion/dualquat.h"
+#include "quaternion/rotate.h"
+#include "pool.h"
+#include "skin.h"
+
+struct skin_job {
+    cgm_vec3* out_pos;
+    cgm_vec3* out_norm;
+    const cgm_vec3* pos;
+    const cgm_vec3* norm;
+    const cgm_uvec4* joints;
+    const cgm_vec4* weights;
+    const cgm_mat4* palette;
+    const cgm_dualquat* dq_palette;
+    size_t n;
+};
+
+static void lbs_chunk(void* ctx, size_t begin, size_t end) {
+    const struct skin_job* job = ctx;
+
+    for (size_t i = begin; i < end; i++) {
+        /* Blend the affine part of the joint matrices, indexed as in
+         * cgm_mat4 (m[3] is the translation)
+         */
+        float m[4][3] = {{0}};
+        for (int k = 0; k < 4; k++) {
+            float w = job->weights[i].v[k];
+            const cgm_mat4* joint = &job->palette[job->joints[i].v[k]];
+            for (int c = 0; c < 4; c++) {
+                m[c][0] += w * joint->m[c][0];
+                m[c][1] += w * joint->m[c][1];
+                m[c][2] += w * joint->m[c][2];
+            }
+        }
+
+        float x = job->pos[i].x, y = job->pos[i].y, z = job->pos[i].z;
+        cgm_vec3_set(&job->out_pos[i],
+                m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0],
+                m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1],
+                m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2]);
+
+        if (job->norm != NULL && job->out_norm != NULL) {
+            x = job->norm[i].x;
+            y = job->norm[i].y;
+            z = job->norm[i].z;
+            cgm_vec3_set(&job->out_norm[i],
+                    m[0][0] * x + m[1][0] * y + m[2][0] * z,
+                    m[0][1] * x + m[1][1] * y + m[2][1] * z,
+                    m[0][2] * x + m[1][2] * y + m[2][2] * z);
+            cgm_vec3_norm(&job->out_norm[i]);
+        }
+    }
+}
+
+static void dqs_chunk(void* ctx, size_t begin, size_t end) {
+    const struct skin_job* job = ctx;
+
+    for (size_t i = begin; i < end; i++) {
+        const cgm_dualquat* first = &job->dq_palette[job->joints[i].x];
+
+        /* Blend the dual quaternions, flipping any whose rotation is in
+         * the opposite hemisphere from the first so that all take the
+         * shortest path
+         */
+        float r[4] = {0}, d[4] = {0};
+        for (int k = 0; k < 4; k++) {
+            const cgm_dualquat* joint = &job->dq_palette[job->joints[i].v[k]];
+            float w = job->weights[i].v[k];
+            if (cgm_quat_dot(&first->real, &joint->real) < 0.0F) {
+                w = -w;
+            }
+
+            for (int c = 0; c < 4; c++) {
+                r[c] += w * joint->real.q[c];
+                d[c] += w * joint->dual.q[c];
+            }
+        }
+
+        /* Normalize by the real part. The dual part does not need to be
+         * made orthogonal: only its component orthogonal to the real part
+         * contributes to the translation below.
+         */
+        float inv = 1.0F / sqrtf(r[0] * r[0] + r[1] * r[1]
+                + r[2] * r[2] + r[3] * r[3]);
+        for (int c = 0; c < 4; c++) {
+            r[c] *= inv;
+            d[c] *= inv;
+        }
+
+        /* Translation: t = 2 vec(dual real*) */
+        float tx = 2.0F * (r[0] * d[1] - d[0] * r[1]
+                + r[2] * d[3] - r[3] * d[2]);
+        float ty = 2.0F * (r[0] * d[2] - d[0] * r[2]
+                + r[3] * d[1] - r[1] * d[3]);
+        float tz = 2.0F * (r[0] * d[3] - d[0] * r[3]
+                + r[1] * d[2] - r[2] * d[1]);
+
+        float x = job->pos[i].x, y = job->pos[i].y, z = job->pos[i].z;
+        cgm_rotate_v3(r[0], r[1], r[2], r[3], &x, &y, &z);
+        cgm_vec3_set(&job->out_pos[i], x + tx, y + ty, z + tz);
+
+        if (job->norm != NULL && job->out_norm != NULL) {
+            x = job->norm[i].x;
+            y = job->norm[i].y;
+            z = job->norm[i].z;
+            cgm_rotate_v3(r[0], r[1], r[2], r[3], &x, &y, &z);
+            cgm_vec3_set(&job->out_norm[i], x, y, z);
+        }
+    }
+}
+
+void cgm_skin_lbs(cgm_vec3* out_pos, cgm_vec3* out_norm,
+        const cgm_vec3* pos, const cgm_vec3* norm,
+        const cgm_uvec4* joints, const cgm_vec4* weights,
+        const cgm_mat4* palette,
+        size_t n, cgm_pool* pool) {
+    struct skin_job job = {out_pos, out_norm, pos, norm,
+        joints, weights, palette, NULL, n};
+    cgm_parallel_for(pool, n, CGM_SKIN_BLOCK, lbs_chunk, &job);
+}
+
+void cgm_skin_dqs(cgm_vec3* out_pos, cgm_vec3* out_norm,
+        const cgm_vec3* pos, const cgm_vec3* norm,
+        const cgm_uvec4* joints, const cgm_vec4* weights,
+        const cgm_dualquat* palette,
+        size_t n, cgm_pool* pool) {
+    struct skin_job job = {out_pos, out_norm, pos, norm,
+        joints, weights, NULL, palette, n};
+    cgm_parallel_for(pool, n, CGM_SKIN_BLOCK, dqs_chunk, &job);
+}
+
+/* vim: set ft=c: */
@@ -0,0 +1,95 @@
+/**
+ * skin.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * Skinning kernels for deforming meshes by a palette of joint
+ * transforms.
+ */
+
+#ifndef SKIN_H_
+#define SKIN_H_
+
+#include <stddef.h>
+
+#include "vector/vec3.h"
+#include "vector/vec4.h"
+#include "vector/uvec4.h"
+#include "matrix/mat4.h"
+#include "quaternion/dualquat.h"
+#include "pool.h"
+
+/**
+ * Number of vertices skinned as one chunk of work when spreading a mesh
+ * over a cgm_pool.
+ */
+#define CGM_SKIN_BLOCK 4096
+
+/**
+ * Deforms vertices by linear blend skinning.
+ * Each vertex is influenced by the 4 joints in joints[i], weighted by the
+ * corresponding components of weights[i]. The affine parts of the 4
+ * palette matrices are blended into one matrix by weight, and that
+ * matrix transforms the position and the normal. Skinned normals are
+ * normalized. Unused influences should be given a weight of 0 (and any
+ * valid joint index).
+ * The palette matrices are assumed to be affine; normals are transformed
+ * by their upper-left 3x3 block, which is only correct for rotations and
+ * uniform scales.
+ * The output arrays may be the same as the input arrays.
+ * @param out_pos - Array of n vectors to store the skinned positions.
+ * @param out_norm - Array of n vectors to store the skinned normals, or
+ *                   NULL to skip the normals.
+ * @param pos - Array of n bind-pose positions.
+ * @param norm - Array of n bind-pose normals, or NULL to skip the
+ *               normals.
+ * @param joints - Array of n sets of palette indices.
+ * @param weights - Array of n sets of joint weights, each summing to 1.
+ * @param palette - Array of joint matrices (the joint's world transform
+ *                  times its inverse bind matrix).
+ * @param n - Number of vertices.
+ * @param pool - Pool of threads to run on, or NULL. Vertices are split
+ *               into chunks of CGM_SKIN_BLOCK, so small meshes use one
+ *               thread regardless.
+ */
+void cgm_skin_lbs(cgm_vec3* out_pos, cgm_vec3* out_norm,
+        const cgm_vec3* pos, const cgm_vec3* norm,
+        const cgm_uvec4* joints, const cgm_vec4* weights,
+        const cgm_mat4* palette,
+        size_t n, cgm_pool* pool);
+
+/**
+ * Deforms vertices by dual quaternion skinning.
+ * This takes the same inputs as cgm_skin_lbs(), except that the palette
+ * holds unit dual quaternions (see cgm_dualquat_from_mat4()). The 4 dual
+ * quaternions of each vertex are blended by weight and normalized, which
+ * keeps the blended transform rigid: joints that twist do not collapse
+ * the mesh as blended matrices do. A dual quaternion palette is also
+ * 8 floats per joint instead of the 12 of an affine matrix.
+ * Rotations in the opposite hemisphere from that of joints[i].x are
+ * negated before blending so that all influences take the shortest path.
+ * Palette entries cannot include scale.
+ * The output arrays may be the same as the input arrays.
+ * @param out_pos - Array of n vectors to store the skinned positions.
+ * @param out_norm - Array of n vectors to store the skinned normals, or
+ *                   NULL to skip the normals.
+ * @param pos - Array of n bind-pose positions.
+ * @param norm - Array of n bind-pose unit normals, or NULL to skip the
+ *               normals.
+ * @param joints - Array of n sets of palette indices.
+ * @param weights - Array of n sets of joint weights, each summing to 1.
+ * @param palette - Array of unit dual quaternion joint transforms.
+ * @param n - Number of vertices.
+ * @param pool - Pool of threads to run on, or NULL, as in
+ *               cgm_skin_lbs().
+ */
+void cgm_skin_dqs(cgm_vec3* out_pos, cgm_vec3* out_norm,
+        const cgm_vec3* pos, const cgm_vec3* norm,
+        const cgm_uvec4* joints, const cgm_vec4* weights,
+        const cgm_dualquat* palette,
+        size_t n, cgm_pool* pool);
+
+#endif /* SKIN_H_ */
+
+/* vim: set ft=c: */
@@ -8,31 +8,100 @@
  */
 
 #include <math.h>
+#include <stdbool.h>
 
 #include "vector/vec3.h"
+#include "vector/vec4.h"
 #include "matrix/mat4.h"
+#include "sincos.h"
 #include "transform.h"
 
+/**
+ * Gets the normalized device depths of the near and far planes.
+ */
+static inline void depth_planes(cgm_depth_range depth,
+        float* near, float* far) {
+    switch (depth) {
+    case CGM_DEPTH_ZERO_TO_ONE:
+        *near = 0;
+        *far = 1;
+        break;
+    case CGM_DEPTH_ONE_TO_ZERO:
+        *near = 1;
+        *far = 0;
+        break;
+    default:
+        *near = -1;
+        *far = 1;
+        break;
+    }
+}
+
 void cgm_set_ortho(
         cgm_mat4* m,
         float left, float right,
         float bottom, float top,
         float near, float far) {
+    cgm_set_ortho_depth(m, left, right, bottom, top, near, far,
+            CGM_DEPTH_NEG_ONE_TO_ONE);
+}
+
+/**
+ * Depth is mapped by z' = a z + b, with a (-near) + b = d_near and
+ * a (-far) + b = d_far.
+ */
+void cgm_set_ortho_depth(
+        cgm_mat4* m,
+        float left, float right,
+        float bottom, float top,
+        float near, float far,
+        cgm_depth_range depth) {
     if (right <= left ||
             top   <= bottom ||
-            far   <= near) {
+            far   <= near ||
+            isinf(far)) {
         return;
     }
 
+    float d_near, d_far;
+    depth_planes(depth, &d_near, &d_far);
+
     cgm_mat4_set_identity(m);
 
     m->m[0][0] = 2 / (right - left);
     m->m[1][1] = 2 / (top - bottom);
-    m->m[2][2] = - 2 / (far - near);
+    m->m[2][2] = (d_near - d_far) / (far - near);
 
     m->m[3][0] = - (right + left) / (right - left);
     m->m[3][1] = - (top + bottom) / (top - bottom);
-    m->m[3][2] = - (far + near)   / (far - near);
+    m->m[3][2] = (d_near * far - d_far * near) / (far - near);
+}
+
+void cgm_set_ortho_inverse(
+        cgm_mat4* m,
+        float left, float right,
+        float bottom, float top,
+        float near, float far,
+        cgm_depth_range depth) {
+    if (right <= left ||
+            top   <= bottom ||
+            far   <= near ||
+            isinf(far)) {
+        return;
+    }
+
+    float d_near, d_far;
+    depth_planes(depth, &d_near, &d_far);
+
+    cgm_mat4_set_identity(m);
+
+    m->m[0][0] = (right - left) / 2;
+    m->m[1][1] = (top - bottom) / 2;
+    m->m[2][2] = (far - near) / (d_near - d_far);
+
+    m->m[3][0] = (right + left) / 2;
+    m->m[3][1] = (top + bottom) / 2;
+    m->m[3][2] = (d_far * near - d_near * far) / (d_near - d_far);
 }
 
 void cgm_ortho(
@@ -56,22 +125,87 @@ void cgm_set_frustum(
         float left, float right,
         float bottom, float top,
         float near, float far) {
+    cgm_set_frustum_depth(m, left, right, bottom, top, near, far,
+            CGM_DEPTH_NEG_ONE_TO_ONE);
+}
+
+/**
+ * Gets the depth terms of a frustum: z' = a z + b and w' = -z, so that
+ * the depth after division, -a - b / z, is d_near at z = -near and d_far
+ * at z = -far. As far goes to infinity, a goes to -d_far and b to
+ * (d_near - d_far) near.
+ */
+static inline void frustum_depth(float near, float far,
+        cgm_depth_range depth, float* a, float* b) {
+    float d_near, d_far;
+    depth_planes(depth, &d_near, &d_far);
+
+    if (isinf(far)) {
+        *a = -d_far;
+        *b = (d_near - d_far) * near;
+    } else {
+        *a = (d_near * near - d_far * far) / (far - near);
+        *b = (d_near - d_far) * far * near / (far - near);
+    }
+}
+
+void cgm_set_frustum_depth(
+        cgm_mat4* m,
+        float left, float right,
+        float bottom, float top,
+        float near, float far,
+        cgm_depth_range depth) {
     if (right <= left ||
             top   <= bottom ||
             far   <= near) {
         return;
     }
 
+    float a, b;
+    frustum_depth(near, far, depth, &a, &b);
+
     cgm_mat4_fill(m, 0);
 
     m->m[0][0] = 2 * near / (right - left);
     m->m[1][1] = 2 * near / (top - bottom);
-    m->m[3][2] = - 2 * far * near / (far - near);
+    m->m[3][2] = b;
     m->m[2][3] = -1;
 
-    m->m[0][2] = (right + left) / (right - left);
-    m->m[1][2] = (top + bottom) / (top - bottom);
-    m->m[2][2] = - (far + near) / (far - near);
+    m->m[2][0] = (right + left) / (right - left);
+    m->m[2][1] = (top + bottom) / (top - bottom);
+    m->m[2][2] = a;
+}
+
+/**
+ * The inverse takes (x', y', z', w') back to x = (x' + c_x w') / s_x,
+ * y = (y' + c_y w') / s_y, z = -w', and w = (z' + a w') / b.
+ */
+void cgm_set_frustum_inverse(
+        cgm_mat4* m,
+        float left, float right,
+        float bottom, float top,
+        float near, float far,
+        cgm_depth_range depth) {
+    if (right <= left ||
+            top   <= bottom ||
+            far   <= near ||
+            near  <= 0) {
+        return;
+    }
+
+    float a, b;
+    frustum_depth(near, far, depth, &a, &b);
+
+    cgm_mat4_fill(m, 0);
+
+    m->m[0][0] = (right - left) / (2 * near);
+    m->m[1][1] = (top - bottom) / (2 * near);
+    m->m[3][0] = (right + left) / (2 * near);
+    m->m[3][1] = (top + bottom) / (2 * near);
+
+    m->m[3][2] = -1;
+    m->m[2][3] = 1 / b;
+    m->m[3][3] = a / b;
 }
 
 void cgm_frustum(
@@ -94,15 +228,52 @@ void cgm_set_perspective(
         cgm_mat4* m,
         float fov_y, float aspect,
         float near, float far) {
+    cgm_set_perspective_depth(m, fov_y, aspect, near, far,
+            CGM_DEPTH_NEG_ONE_TO_ONE);
+}
+
+/**
+ * Gets the half width and height of the near plane of a perspective
+ * projection, or returns false if the arguments are invalid.
+ */
+static inline bool perspective_extent(float fov_y, float aspect,
+        float near, float far, float* width, float* height) {
     if (fov_y < 0 || fov_y > M_PI ||
             aspect < 0 ||
             far <= near) {
-        return;
+        return false;
+    }
+
+    float s, c;
+    cgm_sincos(fov_y / 2, &s, &c);
+
+    *height = s / c * near;
+    *width = *height * aspect;
+    return true;
+}
+
+void cgm_set_perspective_depth(
+        cgm_mat4* m,
+        float fov_y, float aspect,
+        float near, float far,
+        cgm_depth_range depth) {
+    float width, height;
+    if (perspective_extent(fov_y, aspect, near, far, &width, &height)) {
+        cgm_set_frustum_depth(m, -width, width, -height, height,
+                near, far, depth);
     }
+}
 
-    float height = tanf(fov_y / 2) * near;
-    float width = height * aspect;
-    cgm_set_frustum(m, -width, width, -height, height, near, far);
+void cgm_set_perspective_inverse(
+        cgm_mat4* m,
+        float fov_y, float aspect,
+        float near, float far,
+        cgm_depth_range depth) {
+    float width, height;
+    if (perspective_extent(fov_y, aspect, near, far, &width, &height)) {
+        cgm_set_frustum_inverse(m, -width, width, -height, height,
+                near, far, depth);
+    }
 }
 
 void cgm_perspective(
@@ -120,34 +291,76 @@ void cgm_perspective(
     cgm_mat4_mul_l(m, &perspective);
 }
 
-void cgm_set_lookat(
-        cgm_mat4* m,
+/**
+ * Gets the orthonormal basis of a look at view: the side s, up u, and
+ * forward f directions.
+ */
+static inline void lookat_basis(
         const cgm_vec3* eye,
         const cgm_vec3* center,
-        const cgm_vec3* up) {
-    cgm_vec3 f, u, s;
+        const cgm_vec3* up,
+        cgm_vec3* s, cgm_vec3* u, cgm_vec3* f) {
+    cgm_vec3_cpy(f, center);
+    cgm_vec3_sub(f, eye);
+    cgm_vec3_norm(f);
 
-    cgm_vec3_cpy(&f, center);
-    cgm_vec3_sub(&f, eye);
-    cgm_vec3_norm(&f);
+    cgm_vec3_cross(s, f, up);
+    cgm_vec3_norm(s);
 
-    cgm_vec3_cross(&s, &f, up);
-    cgm_vec3_norm(&s);
+    cgm_vec3_cross(u, s, f);
+}
 
-    cgm_vec3_cross(&u, &s, &f);
+/**
+ * Sets m to the view with basis s, u, and f. The rows of its rotation are
+ * s, u, and -f, and the translation is that rotation applied to -eye.
+ */
+static inline void lookat(cgm_mat4* m, const cgm_vec3* eye,
+        const cgm_vec3* s, const cgm_vec3* u, const cgm_vec3* f) {
+    m->m[0][0] =  s->x;
+    m->m[1][0] =  s->y;
+    m->m[2][0] =  s->z;
+    m->m[0][1] =  u->x;
+    m->m[1][1] =  u->y;
+    m->m[2][1] =  u->z;
+    m->m[0][2] = -f->x;
+    m->m[1][2] = -f->y;
+    m->m[2][2] = -f->z;
+
+    m->m[3][0] = -cgm_vec3_dot(s, eye);
+    m->m[3][1] = -cgm_vec3_dot(u, eye);
+    m->m[3][2] =  cgm_vec3_dot(f, eye);
+
+    m->m[0][3] = 0;
+    m->m[1][3] = 0;
+    m->m[2][3] = 0;
+    m->m[3][3] = 1;
+}
 
-    cgm_mat4_set_identity(m);
+void cgm_set_lookat(
+        cgm_mat4* m,
+        const cgm_vec3* eye,
+        const cgm_vec3* center,
+        const cgm_vec3* up) {
+    cgm_vec3 f, u, s;
+    lookat_basis(eye, center, up, &s, &u, &f);
+    lookat(m, eye, &s, &u, &f);
+}
 
-    m->m[0][0] =  s.x;
-    m->m[1][0] =  s.y;
-    m->m[2][0] =  s.z;
-    m->m[0][1] =  u.x;
-    m->m[1][1] =  u.y;
-    m->m[2][1] =  u.z;
-    m->m[0][2] = -f.x;
-    m->m[1][2] = -f.y;
-    m->m[2][2] = -f.z;
-    cgm_translate(m, -eye->x, -eye->y, -eye->z);
+void cgm_set_lookat_inverse(
+        cgm_mat4* m,
+        cgm_mat4* inverse,
+        const cgm_vec3* eye,
+        const cgm_vec3* center,
+        const cgm_vec3* up) {
+    cgm_vec3 f, u, s;
+    lookat_basis(eye, center, up, &s, &u, &f);
+    lookat(m, eye, &s, &u, &f);
+
+    /* The columns of the inverse are s, u, -f, and eye */
+    cgm_vec4_set_v3(&inverse->vec[0], &s, 0);
+    cgm_vec4_set_v3(&inverse->vec[1], &u, 0);
+    cgm_vec4_set(&inverse->vec[2], -f.x, -f.y, -f.z, 0);
+    cgm_vec4_set_v3(&inverse->vec[3], eye, 1);
 }
 
 void cgm_lookat(
@@ -189,8 +402,8 @@ void cgm_scale(cgm_mat4* m, float x, float y, float z) {
 }
 
 void cgm_set_rotate_x(cgm_mat4* m, float ang) {
-    float s = sinf(ang);
-    float c = cosf(ang);
+    float s, c;
+    cgm_sincos(ang, &s, &c);
 
     cgm_mat4_set_identity(m);
     m->m[1][1] = c;
@@ -201,13 +414,13 @@ void cgm_set_rotate_x(cgm_mat4* m, float ang) {
 
 void cgm_rotate_x(cgm_mat4* m, float ang) {
     cgm_mat4 rotate;
-    cgm_rotate_x(&rotate, ang);
+    cgm_set_rotate_x(&rotate, ang);
     cgm_mat4_mul_l(m, &rotate);
 }
 
 void cgm_set_rotate_y(cgm_mat4* m, float ang) {
-    float s = sinf(ang);
-    float c = cosf(ang);
+    float s, c;
+    cgm_sincos(ang, &s, &c);
 
     cgm_mat4_set_identity(m);
     m->m[0][0] = c;
@@ -218,13 +431,13 @@ void cgm_set_rotate_y(cgm_mat4* m, float ang) {
 
 void cgm_rotate_y(cgm_mat4* m, float ang) {
     cgm_mat4 rotate;
-    cgm_rotate_y(&rotate, ang);
+    cgm_set_rotate_y(&rotate, ang);
     cgm_mat4_mul_l(m, &rotate);
 }
 
 void cgm_set_rotate_z(cgm_mat4* m, float ang) {
-    float s = sinf(ang);
-    float c = cosf(ang);
+    float s, c;
+    cgm_sincos(ang, &s, &c);
 
     cgm_mat4_set_identity(m);
     m->m[0][0] = c;
@@ -235,7 +448,7 @@ void cgm_set_rotate_z(cgm_mat4* m, float ang) {
 
 void cgm_rotate_z(cgm_mat4* m, float ang) {
     cgm_mat4 rotate;
-    cgm_rotate_z(&rotate, ang);
+    cgm_set_rotate_z(&rotate, ang);
     cgm_mat4_mul_l(m, &rotate);
 }
 
@@ -249,8 +462,8 @@ void cgm_set_rotate(cgm_mat4* m, const cgm_vec3* axis, float ang) {
     float y = axis->y / mag;
     float z = axis->z / mag;
 
-    float s = sinf(ang);
-    float c = cosf(ang);
+    float s, c;
+    cgm_sincos(ang, &s, &c);
     float p = 1 - c;
 
     cgm_mat4_set_identity(m);
@@ -13,6 +13,28 @@
 #include "vector/vec3.h"
 #include "matrix/mat4.h"
 
+/**
+ * Normalized device depths that the near and far planes of a projection
+ * are mapped to.
+ */
+typedef enum cgm_depth_range {
+    /**
+     * Near to -1 and far to 1 (OpenGL).
+     */
+    CGM_DEPTH_NEG_ONE_TO_ONE,
+
+    /**
+     * Near to 0 and far to 1 (Direct3D, Vulkan, Metal).
+     */
+    CGM_DEPTH_ZERO_TO_ONE,
+
+    /**
+     * Near to 1 and far to 0 (reversed-Z). With a floating point depth
+     * buffer, this spreads precision nearly evenly over the view distance.
+     */
+    CGM_DEPTH_ONE_TO_ZERO,
+} cgm_depth_range;
+
 /**
  * Sets a matrix to an orthographic projection matrix
  * @param m - Matrix to set.
@@ -105,6 +127,118 @@ void cgm_perspective(
         float fov_y, float aspect_ratio,
         float near, float far);
 
+/**
+ * Sets a matrix to an orthographic projection matrix with a given depth
+ * range. cgm_set_ortho() is the same with CGM_DEPTH_NEG_ONE_TO_ONE.
+ * @param m - Matrix to set.
+ * @param left - Left coordinate of the clipping pane.
+ * @param right - Right coordinate of the clipping pane.
+ * @param bottom - Bottom coordinate of the clipping pane.
+ * @param top - Top coordinate of the clipping pane.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane.
+ * @param depth - Depths to map near and far to.
+ */
+void cgm_set_ortho_depth(
+        cgm_mat4* m,
+        float left, float right,
+        float bottom, float top,
+        float near, float far,
+        cgm_depth_range depth);
+
+/**
+ * Sets a matrix to the inverse of cgm_set_ortho_depth() with the same
+ * arguments, built directly rather than by cgm_mat4_invert().
+ * @param m - Matrix to set.
+ * @param left - Left coordinate of the clipping pane.
+ * @param right - Right coordinate of the clipping pane.
+ * @param bottom - Bottom coordinate of the clipping pane.
+ * @param top - Top coordinate of the clipping pane.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane.
+ * @param depth - Depths near and far are mapped to.
+ */
+void cgm_set_ortho_inverse(
+        cgm_mat4* m,
+        float left, float right,
+        float bottom, float top,
+        float near, float far,
+        cgm_depth_range depth);
+
+/**
+ * Sets a matrix to a frustum projection matrix with a given depth range.
+ * far may be INFINITY, for a projection without a far plane.
+ * cgm_set_frustum() is the same with CGM_DEPTH_NEG_ONE_TO_ONE.
+ * @param m - Matrix to set.
+ * @param left - Left coordinate of the clipping pane.
+ * @param right - Right coordinate of the clipping pane.
+ * @param bottom - Bottom coordinate of the clipping pane.
+ * @param top - Top coordinate of the clipping pane.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane, or INFINITY.
+ * @param depth - Depths to map near and far to.
+ */
+void cgm_set_frustum_depth(
+        cgm_mat4* m,
+        float left, float right,
+        float bottom, float top,
+        float near, float far,
+        cgm_depth_range depth);
+
+/**
+ * Sets a matrix to the inverse of cgm_set_frustum_depth() with the same
+ * arguments, built directly rather than by cgm_mat4_invert().
+ * @param m - Matrix to set.
+ * @param left - Left coordinate of the clipping pane.
+ * @param right - Right coordinate of the clipping pane.
+ * @param bottom - Bottom coordinate of the clipping pane.
+ * @param top - Top coordinate of the clipping pane.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane, or INFINITY.
+ * @param depth - Depths near and far are mapped to.
+ */
+void cgm_set_frustum_inverse(
+        cgm_mat4* m,
+        float left, float right,
+        float bottom, float top,
+        float near, float far,
+        cgm_depth_range depth);
+
+/**
+ * Sets a matrix to a perspective projection matrix with a given depth
+ * range. far may be INFINITY, for a projection without a far plane.
+ * cgm_set_perspective() is the same with CGM_DEPTH_NEG_ONE_TO_ONE.
+ * @param m - Matrix to set.
+ * @param fov_y - The Field of View in the y (vertical) direction.
+ *                Measured in radians
+ * @param aspect_ratio - The aspect ratio of the clipping pane.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane, or INFINITY.
+ * @param depth - Depths to map near and far to.
+ */
+void cgm_set_perspective_depth(
+        cgm_mat4* m,
+        float fov_y, float aspect_ratio,
+        float near, float far,
+        cgm_depth_range depth);
+
+/**
+ * Sets a matrix to the inverse of cgm_set_perspective_depth() with the
+ * same arguments, built directly rather than by cgm_mat4_invert().
+ * @param m - Matrix to set.
+ * @param fov_y - The Field of View in the y (vertical) direction.
+ *                Measured in radians
+ * @param aspect_ratio - The aspect ratio of the clipping pane.
+ * @param near - Near coordinate of the depth clipping pane.
+ * @param far - Far coordinate of the depth clipping pane, or INFINITY.
+ * @param depth - Depths near and far are mapped to.
+ */
+void cgm_set_perspective_inverse(
+        cgm_mat4* m,
+        float fov_y, float aspect_ratio,
+        float near, float far,
+        cgm_depth_range depth);
+
 /**
  * Sets a matrix to a look at view matrix.
  * @param m - Matrix to set.
@@ -118,6 +252,22 @@ void cgm_set_lookat(
         const cgm_vec3* center,
         const cgm_vec3* up);
 
+/**
+ * Sets a matrix to a look at view matrix and another to its inverse (the
+ * camera's world matrix), both from the same basis vectors.
+ * @param m - Matrix to set to the view matrix.
+ * @param inverse - Matrix to set to the inverse of the view matrix.
+ * @param eye - Position of the eye.
+ * @param center - Position of the reference point.
+ * @param up - Upward direction.
+ */
+void cgm_set_lookat_inverse(
+        cgm_mat4* m,
+        cgm_mat4* inverse,
+        const cgm_vec3* eye,
+        const cgm_vec3* center,
+        const cgm_vec3* up);
+
 /**
  * Multiplies a matrix by a look at view matrix.
  * @param m - Matrix to multiply.
@@ -64,6 +64,16 @@ typedef union cgm_dvec3 {
     double v[3];
 } cgm_dvec3;
 
+/**
+ * Structure-of-arrays view of a sequence of cgm_dvec3's, as
+ * cgm_vec3_soa is for cgm_vec3's.
+ */
+typedef struct cgm_dvec3_soa {
+    double* x;
+    double* y;
+    double* z;
+} cgm_dvec3_soa;
+
 /**
  * Returns a pointer to a compound literal cgm_dvec3.
  * This should be primarily used as a function parameter
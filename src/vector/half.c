@@ -0,0 +1,123 @@
+/**
+ * half.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+#include "half.h"
+
+typedef union bits {
+    uint32_t u;
+    float f;
+} bits;
+
+/**
+ * Software conversions (after F. Giesen). Denormal halves are handled by
+ * letting the float unit do the shift and rounding: adding (or
+ * subtracting) a magic power of 2 lines the value up with the bits it
+ * has as a half.
+ */
+static inline cgm_half from_float(float f) {
+    const uint32_t f32_inf = 255U << 23;
+    const uint32_t f16_max = (127U + 16U) << 23;
+    const bits denorm_magic = {((127U - 15U) + (23U - 10U) + 1U) << 23};
+
+    bits in = {.f = f};
+    uint32_t sign = in.u & 0x80000000U;
+    in.u ^= sign;
+
+    uint32_t out;
+    if (in.u >= f16_max) {
+        /* Overflow to infinity; NaN stays (quiet) NaN */
+        out = in.u > f32_inf ? 0x7e00U : 0x7c00U;
+    } else if (in.u < (113U << 23)) {
+        /* Denormal or zero half */
+        in.f += denorm_magic.f;
+        out = in.u - denorm_magic.u;
+    } else {
+        /* Normal half: rebias the exponent and round to nearest even */
+        uint32_t odd = (in.u >> 13) & 1U;
+        in.u += ((uint32_t) (15 - 127) << 23) + 0xfffU + odd;
+        out = in.u >> 13;
+    }
+
+    return (cgm_half) (out | sign >> 16);
+}
+
+static inline float to_float(cgm_half h) {
+    const bits magic = {113U << 23};
+    const uint32_t exp_mask = 0x7c00U << 13;
+
+    bits out = {((uint32_t) h & 0x7fffU) << 13};
+    uint32_t exp = out.u & exp_mask;
+    out.u += (127U - 15U) << 23;
+
+    if (exp == exp_mask) {
+        /* Infinity or NaN */
+        out.u += (128U - 16U) << 23;
+    } else if (exp == 0) {
+        /* Zero or denormal: renormalize through the float unit */
+        out.u += 1U << 23;
+        out.f -= magic.f;
+    }
+
+    out.u |= ((uint32_t) h & 0x8000U) << 16;
+    return out.f;
+}
+
+cgm_half cgm_half_from_float(float f) {
+#ifdef __F16C__
+    return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
+#else
+    return from_float(f);
+#endif
+}
+
+float cgm_half_to_float(cgm_half h) {
+#ifdef __F16C__
+    return _cvtsh_ss(h);
+#else
+    return to_float(h);
+#endif
+}
+
+void cgm_half_from_float_n(cgm_half* h, const float* f, size_t n) {
+    size_t i = 0;
+
+#ifdef __F16C__
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm256_cvtps_ph(_mm256_loadu_ps(&f[i]),
+                _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*) &h[i], v);
+    }
+#endif
+
+    for (; i < n; i++) {
+        h[i] = from_float(f[i]);
+    }
+}
+
+void cgm_half_to_float_n(float* f, const cgm_half* h, size_t n) {
+    size_t i = 0;
+
+#ifdef __F16C__
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*) &h[i]);
+        _mm256_storeu_ps(&f[i], _mm256_cvtph_ps(v));
+    }
+#endif
+
+    for (; i < n; i++) {
+        f[i] = to_float(h[i]);
+    }
+}
+
+/* vim: set ft=c: */
@@ -0,0 +1,58 @@
+/**
+ * half.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ *
+ * IEEE 754 half precision (binary16) storage and conversion.
+ * Conversions use the F16C instructions when the library is built with
+ * them enabled (see CGM_F16C in CMakeLists.txt) and an exact software
+ * version otherwise; both round to nearest even.
+ */
+
+#ifndef HALF_H_
+#define HALF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A half precision float, stored as its bits. Halves are only for
+ * storage; arithmetic is done after converting to float.
+ */
+typedef uint16_t cgm_half;
+
+/**
+ * Converts a float to half precision.
+ * Values too large for a half become infinity, and NaN stays NaN.
+ * @param f - The float.
+ * @return The nearest half.
+ */
+cgm_half cgm_half_from_float(float f);
+
+/**
+ * Converts a half to float precision, which is exact.
+ * @param h - The half.
+ * @return The half as a float.
+ */
+float cgm_half_to_float(cgm_half h);
+
+/**
+ * Converts an array of floats to half precision.
+ * @param h - Array of n halves to set.
+ * @param f - Array of n floats.
+ * @param n - Number of values.
+ */
+void cgm_half_from_float_n(cgm_half* h, const float* f, size_t n);
+
+/**
+ * Converts an array of halves to float precision.
+ * @param f - Array of n floats to set.
+ * @param h - Array of n halves.
+ * @param n - Number of values.
+ */
+void cgm_half_to_float_n(float* f, const cgm_half* h, size_t n);
+
+#endif /* HALF_H_ */
+
+/* vim: set ft=c: */
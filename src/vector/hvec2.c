@@ -0,0 +1,38 @@
+/**
+ * hvec2.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <stddef.h>
+
+#include "half.h"
+#include "vec2.h"
+#include "hvec2.h"
+
+void cgm_hvec2_from_vec2(cgm_hvec2* h, const cgm_vec2* v) {
+    h->x = cgm_half_from_float(v->x);
+    h->y = cgm_half_from_float(v->y);
+}
+
+void cgm_hvec2_to_vec2(cgm_vec2* v, const cgm_hvec2* h) {
+    v->x = cgm_half_to_float(h->x);
+    v->y = cgm_half_to_float(h->y);
+}
+
+/* Both types are tightly packed, so the arrays convert as flat arrays */
+void cgm_hvec2_from_vec2_n(cgm_hvec2* h, const cgm_vec2* v, size_t n) {
+    cgm_half_from_float_n(h->v, v->v, 2 * n);
+}
+
+void cgm_hvec2_to_vec2_n(cgm_vec2* v, const cgm_hvec2* h, size_t n) {
+    cgm_half_to_float_n(v->v, h->v, 2 * n);
+}
+
+_Static_assert(sizeof(cgm_hvec2) == 2 * sizeof(cgm_half),
+        "cgm_hvec2 must be tightly packed");
+_Static_assert(sizeof(cgm_vec2) == 2 * sizeof(float),
+        "cgm_vec2 must be tightly packed");
+
+/* vim: set ft=c: */
@@ -0,0 +1,67 @@
+/**
+ * hvec2.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#ifndef HVEC2_H_
+#define HVEC2_H_
+
+#include <stddef.h>
+
+#include "half.h"
+#include "vec2.h"
+
+/**
+ * A 2-dimensional vector with half precision components, for storage.
+ * Convert to a cgm_vec2 to operate on it.
+ */
+typedef union cgm_hvec2 {
+    /**
+     * Half component representation of the vector.
+     */
+    struct {
+        cgm_half x, y;
+    };
+
+    /**
+     * Half array representation of the vector.
+     */
+    cgm_half v[2];
+} cgm_hvec2;
+
+/**
+ * Sets a cgm_hvec2 from a cgm_vec2, rounding each component to
+ * half precision.
+ * @param h - Vector to set.
+ * @param v - Vector from which to set.
+ */
+void cgm_hvec2_from_vec2(cgm_hvec2* h, const cgm_vec2* v);
+
+/**
+ * Sets a cgm_vec2 from a cgm_hvec2.
+ * @param v - Vector to set.
+ * @param h - Vector from which to set.
+ */
+void cgm_hvec2_to_vec2(cgm_vec2* v, const cgm_hvec2* h);
+
+/**
+ * Converts an array of cgm_vec2's to cgm_hvec2's.
+ * @param h - Array of n vectors to set.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_hvec2_from_vec2_n(cgm_hvec2* h, const cgm_vec2* v, size_t n);
+
+/**
+ * Converts an array of cgm_hvec2's to cgm_vec2's.
+ * @param v - Array of n vectors to set.
+ * @param h - Array of n vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_hvec2_to_vec2_n(cgm_vec2* v, const cgm_hvec2* h, size_t n);
+
+#endif /* HVEC2_H_ */
+
+/* vim: set ft=c: */
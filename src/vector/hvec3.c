@@ -0,0 +1,40 @@
+/**
+ * hvec3.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <stddef.h>
+
+#include "half.h"
+#include "vec3.h"
+#include "hvec3.h"
+
+void cgm_hvec3_from_vec3(cgm_hvec3* h, const cgm_vec3* v) {
+    h->x = cgm_half_from_float(v->x);
+    h->y = cgm_half_from_float(v->y);
+    h->z = cgm_half_from_float(v->z);
+}
+
+void cgm_hvec3_to_vec3(cgm_vec3* v, const cgm_hvec3* h) {
+    v->x = cgm_half_to_float(h->x);
+    v->y = cgm_half_to_float(h->y);
+    v->z = cgm_half_to_float(h->z);
+}
+
+/* Both types are tightly packed, so the arrays convert as flat arrays */
+void cgm_hvec3_from_vec3_n(cgm_hvec3* h, const cgm_vec3* v, size_t n) {
+    cgm_half_from_float_n(h->v, v->v, 3 * n);
+}
+
+void cgm_hvec3_to_vec3_n(cgm_vec3* v, const cgm_hvec3* h, size_t n) {
+    cgm_half_to_float_n(v->v, h->v, 3 * n);
+}
+
+_Static_assert(sizeof(cgm_hvec3) == 3 * sizeof(cgm_half),
+        "cgm_hvec3 must be tightly packed");
+_Static_assert(sizeof(cgm_vec3) == 3 * sizeof(float),
+        "cgm_vec3 must be tightly packed");
+
+/* vim: set ft=c: */
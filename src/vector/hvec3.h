@@ -0,0 +1,67 @@
+/**
+ * hvec3.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#ifndef HVEC3_H_
+#define HVEC3_H_
+
+#include <stddef.h>
+
+#include "half.h"
+#include "vec3.h"
+
+/**
+ * A 3-dimensional vector with half precision components, for storage.
+ * Convert to a cgm_vec3 to operate on it.
+ */
+typedef union cgm_hvec3 {
+    /**
+     * Half component representation of the vector.
+     */
+    struct {
+        cgm_half x, y, z;
+    };
+
+    /**
+     * Half array representation of the vector.
+     */
+    cgm_half v[3];
+} cgm_hvec3;
+
+/**
+ * Sets a cgm_hvec3 from a cgm_vec3, rounding each component to
+ * half precision.
+ * @param h - Vector to set.
+ * @param v - Vector from which to set.
+ */
+void cgm_hvec3_from_vec3(cgm_hvec3* h, const cgm_vec3* v);
+
+/**
+ * Sets a cgm_vec3 from a cgm_hvec3.
+ * @param v - Vector to set.
+ * @param h - Vector from which to set.
+ */
+void cgm_hvec3_to_vec3(cgm_vec3* v, const cgm_hvec3* h);
+
+/**
+ * Converts an array of cgm_vec3's to cgm_hvec3's.
+ * @param h - Array of n vectors to set.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_hvec3_from_vec3_n(cgm_hvec3* h, const cgm_vec3* v, size_t n);
+
+/**
+ * Converts an array of cgm_hvec3's to cgm_vec3's.
+ * @param v - Array of n vectors to set.
+ * @param h - Array of n vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_hvec3_to_vec3_n(cgm_vec3* v, const cgm_hvec3* h, size_t n);
+
+#endif /* HVEC3_H_ */
+
+/* vim: set ft=c: */
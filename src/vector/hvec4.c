@@ -0,0 +1,42 @@
+/**
+ * hvec4.c
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#include <stddef.h>
+
+#include "half.h"
+#include "vec4.h"
+#include "hvec4.h"
+
+void cgm_hvec4_from_vec4(cgm_hvec4* h, const cgm_vec4* v) {
+    h->x = cgm_half_from_float(v->x);
+    h->y = cgm_half_from_float(v->y);
+    h->z = cgm_half_from_float(v->z);
+    h->w = cgm_half_from_float(v->w);
+}
+
+void cgm_hvec4_to_vec4(cgm_vec4* v, const cgm_hvec4* h) {
+    v->x = cgm_half_to_float(h->x);
+    v->y = cgm_half_to_float(h->y);
+    v->z = cgm_half_to_float(h->z);
+    v->w = cgm_half_to_float(h->w);
+}
+
+/* Both types are tightly packed, so the arrays convert as flat arrays */
+void cgm_hvec4_from_vec4_n(cgm_hvec4* h, const cgm_vec4* v, size_t n) {
+    cgm_half_from_float_n(h->v, v->v, 4 * n);
+}
+
+void cgm_hvec4_to_vec4_n(cgm_vec4* v, const cgm_hvec4* h, size_t n) {
+    cgm_half_to_float_n(v->v, h->v, 4 * n);
+}
+
+_Static_assert(sizeof(cgm_hvec4) == 4 * sizeof(cgm_half),
+        "cgm_hvec4 must be tightly packed");
+_Static_assert(sizeof(cgm_vec4) == 4 * sizeof(float),
+        "cgm_vec4 must be tightly packed");
+
+/* vim: set ft=c: */
@@ -0,0 +1,67 @@
+/**
+ * hvec4.h
+ *
+ * Copyright (c) 2016 Zach Peltzer.
+ * Subject to the MIT License.
+ */
+
+#ifndef HVEC4_H_
+#define HVEC4_H_
+
+#include <stddef.h>
+
+#include "half.h"
+#include "vec4.h"
+
+/**
+ * A 4-dimensional vector with half precision components, for storage.
+ * Convert to a cgm_vec4 to operate on it.
+ */
+typedef union cgm_hvec4 {
+    /**
+     * Half component representation of the vector.
+     */
+    struct {
+        cgm_half x, y, z, w;
+    };
+
+    /**
+     * Half array representation of the vector.
+     */
+    cgm_half v[4];
+} cgm_hvec4;
+
+/**
+ * Sets a cgm_hvec4 from a cgm_vec4, rounding each component to
+ * half precision.
+ * @param h - Vector to set.
+ * @param v - Vector from which to set.
+ */
+void cgm_hvec4_from_vec4(cgm_hvec4* h, const cgm_vec4* v);
+
+/**
+ * Sets a cgm_vec4 from a cgm_hvec4.
+ * @param v - Vector to set.
+ * @param h - Vector from which to set.
+ */
+void cgm_hvec4_to_vec4(cgm_vec4* v, const cgm_hvec4* h);
+
+/**
+ * Converts an array of cgm_vec4's to cgm_hvec4's.
+ * @param h - Array of n vectors to set.
+ * @param v - Array of n vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_hvec4_from_vec4_n(cgm_hvec4* h, const cgm_vec4* v, size_t n);
+
+/**
+ * Converts an array of cgm_hvec4's to cgm_vec4's.
+ * @param v - Array of n vectors to set.
+ * @param h - Array of n vectors.
+ * @param n - Number of vectors.
+ */
+void cgm_hvec4_to_vec4_n(cgm_vec4* v, const cgm_hvec4* h, size_t n);
+
+#endif /* HVEC4_H_ */
+
+/* vim: set ft=c: */
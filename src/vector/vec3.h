@@ -10,6 +10,7 @@
 #define VEC3_H_
 
 #include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -64,6 +65,19 @@ typedef union cgm_vec3 {
     float v[3];
 } cgm_vec3;
 
+/**
+ * Structure-of-arrays view of a sequence of cgm_vec3's.
+ * Each pointer refers to an array of the same length holding one
+ * component of every vector. Batch functions taking this layout can
+ * process several vectors per instruction, and assume that none of the
+ * arrays they are given overlap.
+ */
+typedef struct cgm_vec3_soa {
+    float* x;
+    float* y;
+    float* z;
+} cgm_vec3_soa;
+
 /**
  * Returns a pointer to a compound literal cgm_vec3.
  * This should be primarily used as a function parameter